@@ -37,12 +37,7 @@ double CClassifier::calcRisk(const CDataMatrix& _data, gsl_vector* _vPredictions
     classify(_data, vPredTmp);
 
     // Compare each prediction with the true label
-    int nbErrors = 0;
-    for (int i = 0; i < _data.nbEx; ++i)
-    {
-        if ( (_data.getY(i)>0.0) != (gsl_vector_get(vPredTmp, i)>0.0) )
-            ++nbErrors;
-    }
+    int nbErrors = countErrors(_data, vPredTmp);
 
     if (_vPredictions == NULL)
         gsl_vector_free(vPredTmp);
@@ -50,3 +45,17 @@ double CClassifier::calcRisk(const CDataMatrix& _data, gsl_vector* _vPredictions
     // Return the proportion of misscllassification
     return (double)nbErrors/_data.nbEx;
 }
+
+
+// Number of predictions whose sign differs from the label of the example
+int CClassifier::countErrors(const CDataMatrix& _data, const gsl_vector* _vPredictions)
+{
+    int nbErrors = 0;
+    for (int i = 0; i < _data.nbEx; ++i)
+    {
+        if ( (_data.getY(i)>0.0) != (gsl_vector_get(_vPredictions, i)>0.0) )
+            ++nbErrors;
+    }
+
+    return nbErrors;
+}
@@ -42,6 +42,9 @@ public:
     // Compute the proportion of missclassification on a datatset
     double              calcRisk(const CDataMatrix& _data, gsl_vector* _vPredictions = NULL);
 
+    // Number of predictions whose sign differs from the label of the example
+    static int          countErrors(const CDataMatrix& _data, const gsl_vector* _vPredictions);
+
     // Allow to save and reconstruct the classifier
     virtual StrValueMap serialize()                         { return StrValueMap(); }
     virtual void        unserialize(StrValueMap& /*_map*/)  { }
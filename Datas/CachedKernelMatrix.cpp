@@ -0,0 +1,135 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+#include "CachedKernelMatrix.h"
+
+#include <algorithm>
+
+using namespace std;
+
+
+// Constructor
+CCachedKernelMatrix::CCachedKernelMatrix(const CDataMatrix& _data, const CKernel& _kernel, double _cacheMB)
+: CImplicitBiasKernelMatrix()
+{
+    m_data   = _data;
+    m_kernel = _kernel;
+
+    Y    = _data.Y;
+    setSize(_data.nbEx);
+
+    // Number of columns fitting in the cache
+    double colBytes = (double)nbEx * sizeof(double);
+    m_nbSlots = (int)min( _cacheMB*1024*1024 / colBytes, (double)nbEx );
+    m_nbSlots = max(m_nbSlots, 2);
+    m_nbUsedSlots = 0;
+
+    m_cache = gsl_matrix_alloc(m_nbSlots, nbEx);
+
+    m_lruPos.resize(nbEx);
+    m_slotOfCol.assign(nbEx, -1);
+
+    m_nbHits   = 0;
+    m_nbMisses = 0;
+}
+
+
+// Desallocate memory (the training examples are not owned by this object)
+void CCachedKernelMatrix::free()
+{
+    CImplicitBiasKernelMatrix::free();
+
+    if (m_cache != NULL) gsl_matrix_free(m_cache);
+    m_cache = NULL;
+
+    m_lru.clear();
+    m_slotOfCol.clear();
+}
+
+
+// Get a kernel column
+gsl_vector CCachedKernelMatrix::getKernelCol(int _j)
+{
+    int slot = m_slotOfCol[_j];
+
+    if (slot >= 0)
+    {
+        // Cache hit: the column becomes the most recently used one
+        ++m_nbHits;
+        m_lru.splice(m_lru.begin(), m_lru, m_lruPos[_j]);
+    }
+    else
+    {
+        // Cache miss: use a free slot, or the one of the least recently used column
+        ++m_nbMisses;
+        if (m_nbUsedSlots < m_nbSlots)
+        {
+            slot = m_nbUsedSlots++;
+        }
+        else
+        {
+            int oldCol = m_lru.back();
+            m_lru.pop_back();
+
+            slot = m_slotOfCol[oldCol];
+            m_slotOfCol[oldCol] = -1;
+        }
+
+        computeCol(_j, slot);
+
+        m_slotOfCol[_j] = slot;
+        m_lru.push_front(_j);
+        m_lruPos[_j] = m_lru.begin();
+    }
+
+    return gsl_matrix_row(m_cache, slot).vector;
+}
+
+
+// Compute column j of the kernel matrix, ie: K[i,j] = kernel( X[i], X[j] ) for each i
+void CCachedKernelMatrix::computeCol(int _j, int _slot)
+{
+    // Sparse examples: the symmetric row j is computed instead (example j is scattered once)
+    if ( m_data.isSparse() )
+    {
+        gsl_matrix_view row = gsl_matrix_view_array( gsl_matrix_ptr(m_cache, _slot, 0), 1, nbEx );
+        m_kernel.fillKernelRows(m_data, _j, 1, &row.matrix);
+        return;
+    }
+
+    // Dataset made of the single example j (a view on the training examples)
+    CDataMatrix example;
+    example.nbEx = 1;
+    example.nbFt = m_data.nbFt;
+
+    gsl_matrix_view xj = gsl_matrix_submatrix(m_data.X, _j, 0, 1, m_data.nbFt);
+    example.X = &xj.matrix;
+
+    CTernaryMatrix xjPacked;
+    if (m_data.T != NULL)
+    {
+        xjPacked  = m_data.T->rows(_j, 1);
+        example.T = &xjPacked;
+    }
+
+    // The slot is seen as a (nbEx x 1) matrix
+    gsl_matrix_view col = gsl_matrix_view_array( gsl_matrix_ptr(m_cache, _slot, 0), nbEx, 1 );
+
+    m_kernel.fillKernelMatrix(m_data, example, &col.matrix);
+
+    example.T = NULL;
+}
@@ -0,0 +1,72 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+#ifndef CACHED_KERNEL_MATRIX_H
+#define CACHED_KERNEL_MATRIX_H
+
+#include "KernelMatrix.h"
+#include "Kernel.h"
+
+#include <list>
+#include <vector>
+
+// Training kernel matrix (train vs train, plus the bias column) computed one column at the time,
+// when a learner requests it. The most recently used columns are kept in a cache of limited
+// size (LRU policy), so the memory used is O(cache size) instead of O(n^2).
+class CCachedKernelMatrix : public CImplicitBiasKernelMatrix
+{
+public:
+    // Constructor / Destructor (the cycle of life!)
+    // _data    : training examples (features matrix and labels)
+    // _cacheMB : size of the column cache, in megabytes (at least two columns are kept)
+    CCachedKernelMatrix(const CDataMatrix& _data, const CKernel& _kernel, double _cacheMB);
+    virtual ~CCachedKernelMatrix()  { }
+
+    // Desallocate memory
+    virtual void        free();
+
+    // Cache statistics
+    int                 getNbSlots() const  { return m_nbSlots; }
+    long                getNbHits() const   { return m_nbHits;  }
+    long                getNbMisses() const { return m_nbMisses;}
+
+protected:
+    // Get a kernel column (computed if not in the cache; the bias column is not cached)
+    virtual gsl_vector  getKernelCol(int _j);
+
+    // Compute column j of the kernel matrix into a cache slot
+    void                computeCol(int _j, int _slot);
+
+    // Training examples and kernel function
+    CDataMatrix         m_data;
+    CKernel             m_kernel;
+
+    // Cached columns (one per row of the matrix)
+    gsl_matrix*         m_cache;
+    int                 m_nbSlots;
+    int                 m_nbUsedSlots;
+
+    // LRU bookkeeping: most recently used columns first
+    std::list<int>                          m_lru;
+    std::vector< std::list<int>::iterator > m_lruPos;       // position of each column in m_lru
+    std::vector<int>                        m_slotOfCol;    // slot of each column (-1 if not cached)
+
+    long                m_nbHits;
+    long                m_nbMisses;
+};
+
+#endif // CACHED_KERNEL_MATRIX_H
@@ -0,0 +1,186 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+
+#include "Coreset.h"
+#include "Utils/MathUtils.h"
+
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+using namespace std;
+
+
+// Constructor
+CCoreset::CCoreset(const CKernel& _kernel, int _size, unsigned long _seed)
+{
+    m_kernel = _kernel;
+    m_size   = _size;
+    m_seed   = _seed;
+
+    if (m_size < 1)
+        throw logic_error("[CCoreset::CCoreset] The coreset size must be positive.");
+}
+
+
+// Weighted coreset of a dataset
+CDataMatrix CCoreset::create(const CDataMatrix& _X)
+{
+    if (_X.Y == NULL)
+        throw logic_error("[CCoreset::create] The examples must be labeled.");
+
+    // Examples (and total weight) of each class
+    map< double, vector<int> >  classes;
+    map< double, double >       classWeights;
+    double                      totalWeight = 0.0;
+
+    for (int i = 0; i < _X.nbEx; ++i)
+    {
+        double w = (_X.W != NULL) ? gsl_vector_get(_X.W, i) : 1.0;
+
+        classes[ _X.getY(i) ].push_back(i);
+        classWeights[ _X.getY(i) ] += w;
+        totalWeight += w;
+    }
+
+    gsl_rng* rng = gsl_rng_alloc(gsl_rng_mt19937);
+    gsl_rng_set(rng, m_seed);
+
+    m_representatives.clear();
+    vector<double> weights;
+
+    map< double, vector<int> >::iterator it;
+    for (it = classes.begin(); it != classes.end(); ++it)
+    {
+        const vector<int>& members = it->second;
+
+        int m = (int)floor( m_size * classWeights[it->first] / totalWeight + 0.5 );
+        m = min( max(m, 1), (int)members.size() );
+
+        CDataMatrix examples = _X.copyExamples(members);
+        seedClass(examples, members, m, rng, weights);
+        examples.free();
+    }
+
+    gsl_rng_free(rng);
+
+    // Representatives in the order of the dataset, with their weights
+    vector< pair<int, double> > sorted;
+    for (size_t k = 0; k < m_representatives.size(); ++k)
+        sorted.push_back( make_pair(m_representatives[k], weights[k]) );
+
+    sort(sorted.begin(), sorted.end());
+
+    for (size_t k = 0; k < sorted.size(); ++k)
+        m_representatives[k] = sorted[k].first;
+
+    CDataMatrix coreset = _X.copyExamples(m_representatives);
+
+    if (coreset.W == NULL)
+        coreset.W = gsl_vector_alloc(coreset.nbEx);
+
+    for (int k = 0; k < coreset.nbEx; ++k)
+        gsl_vector_set(coreset.W, k, sorted[k].second);
+
+    return coreset;
+}
+
+
+// k-means++ seeding among the examples of a class: each new representative is drawn with a
+// probability proportional to the weight of an example times its squared distance to the
+// nearest representative already selected
+void CCoreset::seedClass(const CDataMatrix& _X, const vector<int>& _members, int _m,
+                         gsl_rng* _rng, vector<double>& _weights)
+{
+    int n = _X.nbEx;
+
+    gsl_vector* vWeights = gsl_vector_alloc(n);
+    if (_X.W != NULL)
+        gsl_vector_memcpy(vWeights, _X.W);
+    else
+        gsl_vector_set_all(vWeights, 1.0);
+
+    gsl_vector* vDiag    = gsl_vector_alloc(n);
+    gsl_vector* vCol     = gsl_vector_alloc(n);
+    gsl_vector* vMinDist = gsl_vector_alloc(n);
+    vector<int> nearest(n, -1);
+    vector<int> selected;
+
+    m_kernel.fillKernelDiagonal(_X, vDiag);
+    gsl_vector_set_all(vMinDist, HUGE_VAL);
+
+    // The first representative is drawn according to the weights only
+    gsl_vector_memcpy(vCol, vWeights);
+    double total = MathUtils::sum(vWeights);
+
+    while ( (int)selected.size() < _m )
+    {
+        // Draw the next representative
+        double r = gsl_rng_uniform(_rng) * total;
+        int index = 0;
+        while (index < n-1 && (r -= gsl_vector_get(vCol, index)) > 0.0)
+            ++index;
+
+        if (nearest[index] >= 0 && gsl_vector_get(vMinDist, index) == 0.0)
+            break;
+
+        int k = selected.size();
+        selected.push_back(index);
+
+        // Update the distances to the nearest representative
+        m_kernel.fillKernelColumn(_X, index, vCol);
+
+        total = 0.0;
+        for (int i = 0; i < n; ++i)
+        {
+            double dist = gsl_vector_get(vDiag, i) + gsl_vector_get(vDiag, index) - 2*gsl_vector_get(vCol, i);
+            dist = (i == index) ? 0.0 : max(0.0, dist);
+
+            if (dist < gsl_vector_get(vMinDist, i))
+            {
+                gsl_vector_set(vMinDist, i, dist);
+                nearest[i] = k;
+            }
+
+            // Probability mass of example i for the next draw (kept in vCol)
+            gsl_vector_set(vCol, i, gsl_vector_get(vWeights, i) * gsl_vector_get(vMinDist, i));
+            total += gsl_vector_get(vCol, i);
+        }
+
+        // Every example coincides with a representative
+        if (total <= 0.0)
+            break;
+    }
+
+    // Weight of each representative: total weight of the examples it represents
+    vector<double> weights(selected.size(), 0.0);
+    for (int i = 0; i < n; ++i)
+        weights[ nearest[i] ] += gsl_vector_get(vWeights, i);
+
+    for (size_t k = 0; k < selected.size(); ++k)
+    {
+        m_representatives.push_back( _members[ selected[k] ] );
+        _weights.push_back( weights[k] );
+    }
+
+    gsl_vector_free(vWeights);
+    gsl_vector_free(vDiag);
+    gsl_vector_free(vCol);
+    gsl_vector_free(vMinDist);
+}
@@ -0,0 +1,61 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+
+#ifndef CORESET_H
+#define CORESET_H
+
+#include "Kernel.h"
+
+#include <gsl/gsl_rng.h>
+#include <vector>
+
+// Weighted coreset of a training set: m representative examples, each one weighted by the
+// total weight (multiplicity, see CDataMatrix::W) of the examples it represents.
+// The representatives of each class are selected by k-means++ seeding in the kernel feature
+// space (as the Nystrom landmarks, see CNystrom), with   d(x,r)^2 = k(x,x) + k(r,r) - 2 k(x,r),
+// and each example is represented by its nearest representative of the same class.
+// The classes share the m representatives in proportion of their weights.
+// Time is O(n*m) kernel evaluations, memory O(n).
+class CCoreset
+{
+public:
+    // Constructor / Destructor (the cycle of life!)
+    // _size : number of representatives m (at most the number of examples)
+    CCoreset(const CKernel& _kernel, int _size, unsigned long _seed);
+    ~CCoreset() { }
+
+    // Weighted coreset of a dataset (labels -1/+1): the representatives, in the order of the
+    // dataset, with their weights in W
+    CDataMatrix create(const CDataMatrix& _X);
+
+    // Indices of the representatives in the dataset (after create), in increasing order
+    const std::vector<int>& getRepresentatives() const  { return m_representatives; }
+
+private:
+    // Select _m representatives among the examples of a class (appended to m_representatives,
+    // their weights to _weights)
+    void        seedClass(const CDataMatrix& _X, const std::vector<int>& _members, int _m,
+                          gsl_rng* _rng, std::vector<double>& _weights);
+
+    CKernel             m_kernel;
+    int                 m_size;
+    unsigned long       m_seed;
+    std::vector<int>    m_representatives;
+};
+
+#endif // CORESET_H
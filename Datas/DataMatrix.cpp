@@ -17,6 +17,10 @@
 #include "DataMatrix.h"
 #include "Utils/FileUtils.h"
 #include "Utils/MathUtils.h"
+#include "Utils/MappedFile.h"
+#include "Utils/Allocator.h"
+#include <cstdlib>
+#include <cstring>
 #include <vector>
 #include <algorithm>
 #include "gsl/gsl_matrix.h"
@@ -28,10 +32,15 @@ using namespace std;
 CDataMatrix::CDataMatrix()
 {
     X = NULL;
+    S = NULL;
+    T = NULL;
     Y = NULL;
+    W = NULL;
     
     nbFt = 0;
     nbEx = 0;
+
+    m_pMappedFile = NULL;
 }
 
 
@@ -41,7 +50,7 @@ void CDataMatrix::init(int _nbEx, int _nbFt, bool _bLabelVector /*= true*/)
     nbEx = _nbEx;
     nbFt = _nbFt;
 
-    X = gsl_matrix_alloc(nbEx, nbFt);
+    allocX();
 
     if (_bLabelVector)
         Y = gsl_vector_alloc(nbEx);
@@ -50,17 +59,64 @@ void CDataMatrix::init(int _nbEx, int _nbFt, bool _bLabelVector /*= true*/)
 }
 
 
+// Allocate the features matrix: in memory placed by the default allocator, if it takes care
+// of a matrix of that size, otherwise by GSL
+void CDataMatrix::allocX()
+{
+    CMappedFile* pBlock = CAllocator::getDefault().allocate(nbEx, nbFt*sizeof(double));
+
+    if (pBlock == NULL)
+    {
+        X = gsl_matrix_alloc(nbEx, nbFt);
+        return;
+    }
+
+    // Matrix structure pointing into the block (it does not own its memory, see 'free')
+    X = (gsl_matrix*)malloc(sizeof(gsl_matrix));
+    X->size1 = nbEx;
+    X->size2 = nbFt;
+    X->tda   = nbFt;
+    X->data  = (double*)pBlock->data();
+    X->block = NULL;
+    X->owner = 0;
+
+    m_pMappedFile = pBlock;
+}
+
+
 // Desallocate memory
 void CDataMatrix::free()
 {
     if (X != NULL)  gsl_matrix_free(X);
     if (Y != NULL)  gsl_vector_free(Y);
+    if (W != NULL)  gsl_vector_free(W);
+
+    if (S != NULL)
+    {
+        S->free();
+        delete S;
+    }
+
+    if (T != NULL)
+    {
+        T->free();
+        delete T;
+    }
 
     X = NULL;
+    S = NULL;
+    T = NULL;
     Y = NULL;
+    W = NULL;
 
     nbEx = 0;
     nbFt = 0;
+
+    // The matrix and vector above did not own their memory: release the mapping
+    if (m_pMappedFile != NULL)
+        delete m_pMappedFile;
+
+    m_pMappedFile = NULL;
 }
 
 
@@ -69,6 +125,18 @@ void CDataMatrix::free()
 // (specified _bFirstColumnAsLabels=false if the data is unlabled)
 int CDataMatrix::loadFromFile(const char* _sFilename, bool _bFirstColumnAsLabels /*= true*/)
 {
+    // Sparse examples are detected from the first line
+    {
+        ifstream file(_sFilename);
+        string   strLine;
+
+        while ( getline(file, strLine) && FileUtils::trim(strLine).empty() )
+            ;
+
+        if ( strLine.find(':') != string::npos )
+            return loadSparseFile(_sFilename, _bFirstColumnAsLabels);
+    }
+
     vector< vector<double> > tab;
 
     FileUtils::STabInfo info = FileUtils::readTab(_sFilename, tab);
@@ -101,10 +169,201 @@ int CDataMatrix::loadFromFile(const char* _sFilename, bool _bFirstColumnAsLabels
             gsl_matrix_set(X, i, j, tab[i][j+jFirst]);
     }
 
+    // Ternary features: kernels are computed from the bit-packed examples
+    if ( CTernaryMatrix::isTernary(X) )
+        T = CTernaryMatrix::pack(X);
+
     return info.nbLines;
 }
 
 
+// Load a file of sparse examples: "label index:value index:value ...", one line by example.
+// Indices start at 1 and are increasing on each line; text following a '#' is ignored.
+// The number of features is the largest index found.
+int CDataMatrix::loadSparseFile(const char* _sFilename, bool _bFirstColumnAsLabels)
+{
+    ifstream file(_sFilename);
+    if ( !file.is_open() )
+    {
+        cerr << "[CDataMatrix::loadSparseFile] Error while reading file." << endl;
+        return 0;
+    }
+
+    vector<double>  labels;
+    vector<size_t>  rowStart(1, 0);
+    vector<int>     colIndex;
+    vector<double>  values;
+    int             maxIndex = 0;
+
+    string strLine;
+    while ( getline(file, strLine) )
+    {
+        size_t comment = strLine.find('#');
+        if (comment != string::npos)
+            strLine.erase(comment);
+
+        strLine = FileUtils::trim(strLine);
+        if ( strLine.empty() )  // Skip empty lines
+            continue;
+
+        const char* pos = strLine.c_str();
+        char*       end;
+
+        if (_bFirstColumnAsLabels)
+        {
+            labels.push_back( strtod(pos, &end) );
+            pos = end;
+        }
+
+        while (true)
+        {
+            long index = strtol(pos, &end, 10);
+            if (end == pos || *end != ':')
+                break;
+
+            double value = strtod(end+1, &end);
+            pos = end;
+
+            if (index < 1)
+            {
+                cerr << "[CDataMatrix::loadSparseFile] Invalid feature index " << index << "." << endl;
+                return 0;
+            }
+
+            if (value != 0.0)
+            {
+                colIndex.push_back(index-1);
+                values.push_back(value);
+                maxIndex = max(maxIndex, (int)index);
+            }
+        }
+
+        rowStart.push_back( colIndex.size() );
+    }
+
+    free();
+
+    nbEx = rowStart.size()-1;
+    nbFt = maxIndex;
+
+    S = new CSparseMatrix();
+    S->init(nbEx, nbFt, colIndex.size());
+
+    copy(rowStart.begin(), rowStart.end(), S->rowStart);
+    copy(colIndex.begin(), colIndex.end(), S->colIndex);
+    copy(values.begin(),   values.end(),   S->values);
+
+    if (_bFirstColumnAsLabels)
+    {
+        Y = gsl_vector_alloc(nbEx);
+        MathUtils::assign(Y, labels);
+    }
+
+    return nbEx;
+}
+
+
+// Order of the examples by label, then by features (dense or sparse rows), used to find the
+// duplicates. Equal examples are ordered by index.
+struct SExampleOrder
+{
+    const CDataMatrix*  m_pData;
+
+    int compare(int _i, int _j) const
+    {
+        const CDataMatrix& D = *m_pData;
+
+        if (D.Y != NULL && D.getY(_i) != D.getY(_j))
+            return D.getY(_i) < D.getY(_j) ? -1 : 1;
+
+        if (D.S != NULL)
+        {
+            size_t ki = D.S->rowStart[_i], kEndI = D.S->rowStart[_i+1];
+            size_t kj = D.S->rowStart[_j], kEndJ = D.S->rowStart[_j+1];
+
+            for ( ; ki < kEndI && kj < kEndJ; ++ki, ++kj)
+            {
+                if (D.S->colIndex[ki] != D.S->colIndex[kj])
+                    return D.S->colIndex[ki] < D.S->colIndex[kj] ? -1 : 1;
+                if (D.S->values[ki] != D.S->values[kj])
+                    return D.S->values[ki] < D.S->values[kj] ? -1 : 1;
+            }
+
+            return (ki < kEndI) - (kj < kEndJ);
+        }
+
+        const double* xi = gsl_matrix_const_ptr(D.X, _i, 0);
+        const double* xj = gsl_matrix_const_ptr(D.X, _j, 0);
+
+        for (int k = 0; k < D.nbFt; ++k)
+        {
+            if (xi[k] != xj[k])
+                return xi[k] < xj[k] ? -1 : 1;
+        }
+
+        return 0;
+    }
+
+    bool operator()(int _i, int _j) const
+    {
+        int c = compare(_i, _j);
+        return c != 0 ? c < 0 : _i < _j;
+    }
+};
+
+
+// Merge the identical examples into their first occurrence (multiplicity kept in W)
+int CDataMatrix::mergeDuplicates()
+{
+    SExampleOrder order = { this };
+
+    vector<int> sorted(nbEx);
+    for (int i = 0; i < nbEx; ++i)
+        sorted[i] = i;
+
+    sort(sorted.begin(), sorted.end(), order);
+
+    // First occurrence of each group of identical examples, and its multiplicity (the sum of
+    // the multiplicities, if the examples are already merged ones)
+    vector<double>  count(nbEx, 0.0);
+    vector<int>     kept;
+
+    for (int k = 0; k < nbEx; )
+    {
+        int first = sorted[k];
+        int end   = k+1;
+
+        while (end < nbEx && order.compare(first, sorted[end]) == 0)
+            ++end;
+
+        for (int g = k; g < end; ++g)
+            count[first] += (W != NULL) ? gsl_vector_get(W, sorted[g]) : 1.0;
+
+        kept.push_back(first);
+        k = end;
+    }
+
+    int nbRemoved = nbEx - kept.size();
+    if (nbRemoved == 0)
+        return 0;
+
+    // Kept examples, in their original order
+    sort(kept.begin(), kept.end());
+    CDataMatrix merged = copyExamples(kept);
+
+    if (merged.W == NULL)
+        merged.W = gsl_vector_alloc(merged.nbEx);
+
+    for (int k = 0; k < merged.nbEx; ++k)
+        gsl_vector_set(merged.W, k, count[ kept[k] ]);
+
+    free();
+    *this = merged;
+
+    return nbRemoved;
+}
+
+
 // Save a dataset file
 // one line by example; first column contains labels, if any.
 bool CDataMatrix::saveToFile(const char* _sFilename)
@@ -114,6 +373,23 @@ bool CDataMatrix::saveToFile(const char* _sFilename)
     if ( !file.is_open() )
         return false;
 
+    // Sparse examples: "label index:value ..."
+    if (S != NULL)
+    {
+        for (int i = 0; i < nbEx; ++i)
+        {
+            if (Y != NULL)
+                file << gsl_vector_get(Y, i);
+
+            for (size_t k = S->rowStart[i]; k < S->rowStart[i+1]; ++k)
+                file << ((Y != NULL || k > S->rowStart[i]) ? " " : "") << S->colIndex[k]+1 << ":" << S->values[k];
+
+            file << endl;
+        }
+
+        return true;
+    }
+
     // Write file one line at the time
     for (int i = 0; i < nbEx; ++i)
     {
@@ -138,6 +414,97 @@ bool CDataMatrix::saveToFile(const char* _sFilename)
 }
 
 
+// Identification of the binary file format
+static const char   BINARY_MAGIC[8] = { 'P','B','S','C','M','A','T','\0' };
+static const int    BINARY_VERSION  = 1;
+
+
+// Save a binary file: header, features matrix (row by row) and labels vector, if any.
+// The file is written through a shared mapping (it may be a shared memory object, see
+// CMappedFile), and its header is written last: a partially written file is never valid.
+bool CDataMatrix::saveToBinaryFile(const char* _sFilename)
+{
+    size_t nbValues = (size_t)nbEx * (nbFt + (Y != NULL ? 1 : 0));
+
+    CMappedFile file;
+    if ( !file.create(_sFilename, sizeof(SBinaryHeader) + nbValues*sizeof(double)) )
+        return false;
+
+    double* data = (double*)( (char*)file.data() + sizeof(SBinaryHeader) );
+
+    for (int i = 0; i < nbEx; ++i, data += nbFt)
+        memcpy(data, gsl_matrix_const_ptr(X, i, 0), nbFt*sizeof(double));
+
+    for (int i = 0; i < nbEx && Y != NULL; ++i)
+        *data++ = gsl_vector_get(Y, i);
+
+    SBinaryHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, BINARY_MAGIC, sizeof(header.magic));
+    header.version  = BINARY_VERSION;
+    header.nbEx     = nbEx;
+    header.nbFt     = nbFt;
+    header.bLabels  = (Y != NULL);
+
+    memcpy(file.data(), &header, sizeof(header));
+
+    return true;
+}
+
+
+// Map a binary file in memory (saved by 'saveToBinaryFile')
+bool CDataMatrix::mapBinaryFile(const char* _sFilename)
+{
+    CMappedFile* pFile = new CMappedFile();
+
+    if ( !pFile->open(_sFilename, true) || pFile->size() < sizeof(SBinaryHeader) )
+    {
+        delete pFile;
+        return false;
+    }
+
+    const SBinaryHeader* header = (const SBinaryHeader*)pFile->data();
+    size_t nbValues = (size_t)header->nbEx * (header->nbFt + (header->bLabels ? 1 : 0));
+
+    if ( memcmp(header->magic, BINARY_MAGIC, sizeof(header->magic)) != 0
+         || header->version != BINARY_VERSION
+         || pFile->size() != sizeof(SBinaryHeader) + nbValues*sizeof(double) )
+    {
+        delete pFile;
+        return false;
+    }
+
+    free();
+
+    nbEx = header->nbEx;
+    nbFt = header->nbFt;
+    double* data = (double*)( (char*)pFile->data() + sizeof(SBinaryHeader) );
+
+    // Matrix and vector structures pointing into the mapped file (they do not own their memory)
+    X = (gsl_matrix*)malloc(sizeof(gsl_matrix));
+    X->size1 = nbEx;
+    X->size2 = nbFt;
+    X->tda   = nbFt;
+    X->data  = data;
+    X->block = NULL;
+    X->owner = 0;
+
+    if (header->bLabels)
+    {
+        Y = (gsl_vector*)malloc(sizeof(gsl_vector));
+        Y->size   = nbEx;
+        Y->stride = 1;
+        Y->data   = data + (size_t)nbEx*nbFt;
+        Y->block  = NULL;
+        Y->owner  = 0;
+    }
+
+    m_pMappedFile = pFile;
+
+    return true;
+}
+
+
 // Make a new copy of this dataset
 CDataMatrix CDataMatrix::duplicate()
 {
@@ -148,10 +515,16 @@ CDataMatrix CDataMatrix::duplicate()
 
     if (X != NULL)
     {
-        newData.X = gsl_matrix_alloc(nbEx, nbFt);
+        newData.allocX();
         gsl_matrix_memcpy(newData.X, X);
     }
 
+    if (S != NULL)
+        newData.S = S->duplicate();
+
+    if (T != NULL)
+        newData.T = T->duplicate();
+
     if (Y != NULL)
     {
         newData.Y = gsl_vector_alloc(nbEx);
@@ -163,42 +536,78 @@ CDataMatrix CDataMatrix::duplicate()
 
 
 // Make a new copy of this dataset and select desired examples (matrix rows):
-// - If _bInverse==true, keep only examples of indexes in _vIndexes.
+// - If _bInverse==false, keep only examples of indexes in _vIndexes.
 // - Otherwise, keep only examples of indexes not in _vIndexes.
-CDataMatrix CDataMatrix::copyExamples(vector<int> _vIndexes, bool _bInverse /*= false*/)
+// Dense or sparse features, their bit-packed copy, labels and multiplicities are copied.
+CDataMatrix CDataMatrix::copyExamples(vector<int> _vIndexes, bool _bInverse /*= false*/) const
 {
     sort(_vIndexes.begin(), _vIndexes.end());
-    unique(_vIndexes.begin(), _vIndexes.end());
+    _vIndexes.erase( unique(_vIndexes.begin(), _vIndexes.end()), _vIndexes.end() );
 
-    CDataMatrix newData;
+    vector<int> selected;
 
-    newData.init( _bInverse ? nbEx - _vIndexes.size() : _vIndexes.size(),
-                  nbFt );
-
-    bool bCopy;
-    int j=0;
-    int k=0;
-    for (int i = 0; i < nbEx && j < newData.nbEx; ++i)
+    if (_bInverse)
     {
-        bCopy = false;
-        if (i == _vIndexes[j])
+        for (int i = 0; i < nbEx; ++i)
         {
-            ++j;
-            if (!_bInverse)
-                bCopy = true;
+            if ( !binary_search(_vIndexes.begin(), _vIndexes.end(), i) )
+                selected.push_back(i);
         }
-        else if (_bInverse)
+    }
+    else
+        selected = _vIndexes;
+
+    CDataMatrix newData;
+
+    newData.nbEx = selected.size();
+    newData.nbFt = nbFt;
+
+    if (S != NULL)
+    {
+        size_t nbNonZeros = 0;
+        for (int k = 0; k < newData.nbEx; ++k)
+            nbNonZeros += S->getRowSize( selected[k] );
+
+        newData.S = new CSparseMatrix();
+        newData.S->init(newData.nbEx, nbFt, nbNonZeros);
+        newData.S->rowStart[0] = 0;
+
+        for (int k = 0; k < newData.nbEx; ++k)
         {
-            bCopy = true;
+            size_t first = S->rowStart[ selected[k] ], last = S->rowStart[ selected[k]+1 ];
+            size_t start = newData.S->rowStart[k];
+
+            copy(S->colIndex + first, S->colIndex + last, newData.S->colIndex + start);
+            copy(S->values   + first, S->values   + last, newData.S->values   + start);
+            newData.S->rowStart[k+1] = start + (last - first);
         }
+    }
+    else
+    {
+        newData.X = gsl_matrix_alloc(newData.nbEx, nbFt);
 
-        if (bCopy)
+        for (int k = 0; k < newData.nbEx; ++k)
         {
-            gsl_vector_view row = gsl_matrix_row(X, i);
+            gsl_vector_view row = gsl_matrix_row(X, selected[k]);
             gsl_matrix_set_row(newData.X, k, &(row.vector));
-            gsl_vector_set(newData.Y, k, gsl_vector_get(Y, i));
-            ++k;
         }
+
+        if (T != NULL)
+            newData.T = CTernaryMatrix::pack(newData.X);
+    }
+
+    if (Y != NULL)
+    {
+        newData.Y = gsl_vector_alloc(newData.nbEx);
+        for (int k = 0; k < newData.nbEx; ++k)
+            gsl_vector_set(newData.Y, k, gsl_vector_get(Y, selected[k]));
+    }
+
+    if (W != NULL)
+    {
+        newData.W = gsl_vector_alloc(newData.nbEx);
+        for (int k = 0; k < newData.nbEx; ++k)
+            gsl_vector_set(newData.W, k, gsl_vector_get(W, selected[k]));
     }
 
     return newData;
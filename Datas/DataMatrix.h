@@ -17,15 +17,23 @@
 #ifndef DATA_MATRIX_H
 #define	DATA_MATRIX_H
 
+#include "SparseMatrix.h"
+#include "TernaryMatrix.h"
+
 #include <gsl/gsl_matrix.h>
 #include <vector>
 
+class CMappedFile;
+
 class CDataMatrix
 {
 public:
     // Dataset values (declared 'public' for more commodity)
     gsl_matrix*     X;  // Features matrix (one example per line)
+    CSparseMatrix*  S;  // Sparse features matrix, used instead of X (NULL for dense features)
+    CTernaryMatrix* T;  // Bit-packed copy of X (kept too), when all features are -1, 0 or +1 (NULL otherwise)
     gsl_vector*     Y;  // Labels vector
+    gsl_vector*     W;  // Multiplicity of each example, once the duplicates are merged (NULL otherwise)
     int             nbEx, nbFt; // Matrix size [nb examples]x[nb features]
 
 public:
@@ -33,14 +41,35 @@ public:
     CDataMatrix();
     virtual ~CDataMatrix()  {}
 
-    // Allocate / Desallocate memory
+    // Allocate / Desallocate memory. A features matrix of at least one huge page (a kernel matrix
+    // or a dataset) is placed by the default allocator (huge pages, NUMA nodes, see
+    // CAllocator::getDefault)
     void        init(int _nbEx, int _nbFt, bool _bLabelVector = true);
     void        free();
 
-    // File management (one line by example; first column contains labels, if any)
+    // True if the features are stored in the sparse matrix S (then X == NULL)
+    bool        isSparse() const    { return S != NULL; }
+
+    // File management (one line by example; first column contains labels, if any).
+    // A file of sparse examples ("label index:value index:value ...", indices from 1, as in
+    // the SVMlight format) is detected and loaded into the sparse matrix S. Dense examples whose
+    // features are all -1, 0 or +1 are also packed into T, which speeds up their kernel values
+    // (X remains, since the other computations read it: the memory grows by 1/32).
     int         loadFromFile(const char* _sFilename, bool _bLastColumnAsLabels = true);
     bool        saveToFile(const char* _sFilename);
 
+    // Merge the identical examples (same label and features) into the first one, whose
+    // multiplicity is kept in W. The order of the first occurrences is preserved, so that merging
+    // the same file always gives the same examples. Returns the number of examples removed
+    // (W remains NULL if there is none).
+    int         mergeDuplicates();
+
+    // Binary file management. A binary file is mapped in memory without any copy
+    // (copy-on-write, the mapping is released by free()). The file name may designate a
+    // shared memory object ("shm:/name", see CMappedFile).
+    bool        saveToBinaryFile(const char* _sFilename);
+    bool        mapBinaryFile(const char* _sFilename);
+
     // Set / Get an attribute value (example i, attribute j)
     void        setX(int _i, int _j, double _value);
     double      getX(int _i, int _j) const;
@@ -61,12 +90,31 @@ public:
     // vIndexes allows to select a subset of examples / attributes
     // If bInverse==true, vIndexes indicates examples / attributes that we DO NOT want.
     CDataMatrix duplicate();
-    CDataMatrix copyExamples(std::vector<int> _vIndexes, bool _bInverse = false);
+    CDataMatrix copyExamples(std::vector<int> _vIndexes, bool _bInverse = false) const;
     CDataMatrix copyAttributes(std::vector<int> _vIndexes, bool _bInverse = false);
 
 
 private:
-
+    // Allocate the features matrix X (nbEx x nbFt)
+    void        allocX();
+
+    // Load a file of sparse examples
+    int         loadSparseFile(const char* _sFilename, bool _bFirstColumnAsLabels);
+
+    // Header of a binary file (followed by the features matrix, then by the labels vector)
+    struct SBinaryHeader
+    {
+        char    magic[8];
+        int     version;
+        int     nbEx;
+        int     nbFt;
+        int     bLabels;
+        char    padding[40];    // the matrix starts on a 64 bytes boundary
+    };
+
+    // Memory mapped file containing the matrix, or memory placed by the allocator (NULL if the
+    // matrix is allocated by GSL)
+    CMappedFile*    m_pMappedFile;
 };
 
 
@@ -0,0 +1,159 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+
+#include "DataPipeline.h"
+
+#include <stdexcept>
+
+using namespace std;
+
+
+// Constructor
+CDataPipeline::CDataPipeline(int _blockSize, int _queueSize)
+{
+    if (_blockSize < 1 || _queueSize < 1)
+        throw logic_error("[CDataPipeline::CDataPipeline] The block and queue sizes must be positive.");
+
+    m_blockSize = _blockSize;
+    m_queueSize = _queueSize;
+    m_status    = 0;
+    m_bStop     = false;
+    m_bRunning  = false;
+
+    pthread_mutex_init(&m_mutex, NULL);
+    pthread_cond_init(&m_cond, NULL);
+}
+
+
+// Destructor
+CDataPipeline::~CDataPipeline()
+{
+    stop();
+
+    pthread_mutex_destroy(&m_mutex);
+    pthread_cond_destroy(&m_cond);
+}
+
+
+// Open a dataset file and start the reading thread
+bool CDataPipeline::start(const char* _sFilename, bool _bFirstColumnAsLabels /*= true*/)
+{
+    stop();
+
+    if ( !m_stream.open(_sFilename, _bFirstColumnAsLabels) )
+        return false;
+
+    m_status = 1;
+    m_bStop  = false;
+
+    if ( pthread_create(&m_thread, NULL, run, this) != 0 )
+    {
+        m_stream.close();
+        return false;
+    }
+
+    m_bRunning = true;
+    return true;
+}
+
+
+// Entry point of the reading thread
+void* CDataPipeline::run(void* _pPipeline)
+{
+    ((CDataPipeline*)_pPipeline)->read();
+    return NULL;
+}
+
+
+// Read the blocks, until the end of the file (or until stopped)
+void CDataPipeline::read()
+{
+    while (true)
+    {
+        CDataMatrix block;
+        int nbRead = m_stream.read(block, m_blockSize);
+
+        pthread_mutex_lock(&m_mutex);
+
+        while ( !m_bStop && (int)m_queue.size() >= m_queueSize )
+            pthread_cond_wait(&m_cond, &m_mutex);
+
+        if (m_bStop)
+            block.free();
+        else if (nbRead > 0)
+            m_queue.push_back(block);
+        else
+            m_status = nbRead;
+
+        bool bDone = m_bStop || nbRead <= 0;
+
+        pthread_cond_broadcast(&m_cond);
+        pthread_mutex_unlock(&m_mutex);
+
+        if (bDone)
+            return;
+    }
+}
+
+
+// Next block of examples
+int CDataPipeline::next(CDataMatrix& _block)
+{
+    pthread_mutex_lock(&m_mutex);
+
+    while ( m_queue.empty() && m_status > 0 )
+        pthread_cond_wait(&m_cond, &m_mutex);
+
+    int nbRead = m_status;
+    if ( !m_queue.empty() )
+    {
+        _block = m_queue.front();
+        m_queue.pop_front();
+        nbRead = _block.nbEx;
+    }
+
+    pthread_cond_broadcast(&m_cond);
+    pthread_mutex_unlock(&m_mutex);
+
+    return nbRead;
+}
+
+
+// Stop the reading thread
+void CDataPipeline::stop()
+{
+    if (m_bRunning)
+    {
+        pthread_mutex_lock(&m_mutex);
+        m_bStop = true;
+        pthread_cond_broadcast(&m_cond);
+        pthread_mutex_unlock(&m_mutex);
+
+        pthread_join(m_thread, NULL);
+        m_bRunning = false;
+    }
+
+    while ( !m_queue.empty() )
+    {
+        m_queue.front().free();
+        m_queue.pop_front();
+    }
+
+    m_stream.close();
+    m_status = 0;
+}
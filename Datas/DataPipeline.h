@@ -0,0 +1,72 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+
+#ifndef DATA_PIPELINE_H
+#define DATA_PIPELINE_H
+
+#include "DataStream.h"
+
+#include <pthread.h>
+#include <deque>
+
+// Dataset file read by a thread, by blocks of examples (see CDataStream), while the blocks
+// already read are processed by the caller (see next). At most '_queueSize' blocks wait in the
+// queue: the reading pauses when the processing is slower, so that the memory stays bounded.
+class CDataPipeline
+{
+public:
+    // Constructor / Destructor (the cycle of life!)
+    CDataPipeline(int _blockSize, int _queueSize);
+    virtual ~CDataPipeline();
+
+    // Open a dataset file and start reading it (false if the file cannot be opened)
+    bool        start(const char* _sFilename, bool _bFirstColumnAsLabels = true);
+
+    // Next block of examples, to be freed by the caller (waits until it is read). Returns the
+    // number of examples of the block: 0 at the end of the file, -1 if a line is invalid.
+    int         next(CDataMatrix& _block);
+
+    // Stop the reading thread, and free the blocks not processed
+    void        stop();
+
+private:
+    // Not copyable (the thread uses this object)
+    CDataPipeline(const CDataPipeline&);
+    CDataPipeline& operator=(const CDataPipeline&);
+
+    // Reading thread
+    static void*    run(void* _pPipeline);
+    void            read();
+
+    CDataStream             m_stream;
+    int                     m_blockSize;
+    int                     m_queueSize;
+
+    // Blocks read, and state of the reading (1 = reading, 0 = end of file, -1 = invalid line),
+    // protected by the mutex. The condition is signaled whenever they change.
+    std::deque<CDataMatrix> m_queue;
+    int                     m_status;
+    bool                    m_bStop;
+
+    bool                    m_bRunning;
+    pthread_t               m_thread;
+    pthread_mutex_t         m_mutex;
+    pthread_cond_t          m_cond;
+};
+
+#endif // DATA_PIPELINE_H
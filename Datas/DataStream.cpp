@@ -0,0 +1,236 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+
+#include "DataStream.h"
+#include "Utils/FileUtils.h"
+#include "Utils/MathUtils.h"
+
+#include <cstdlib>
+#include <algorithm>
+#include <iostream>
+
+using namespace std;
+
+
+// Constructor
+CDataStream::CDataStream()
+{
+    m_bLabels = true;
+    m_bSparse = false;
+    m_nbFt    = 0;
+    m_nbRead  = 0;
+}
+
+
+// Open a dataset file
+bool CDataStream::open(const char* _sFilename, bool _bFirstColumnAsLabels /*= true*/)
+{
+    close();
+
+    m_file.open(_sFilename);
+    if ( !m_file.is_open() )
+        return false;
+
+    // Sparse examples are detected from the first line
+    string strLine;
+    while ( getline(m_file, strLine) && FileUtils::trim(strLine).empty() )
+        ;
+
+    m_bLabels = _bFirstColumnAsLabels;
+    m_bSparse = ( strLine.find(':') != string::npos );
+
+    m_file.clear();
+    m_file.seekg(0);
+
+    return true;
+}
+
+
+// Close the file
+void CDataStream::close()
+{
+    if ( m_file.is_open() )
+        m_file.close();
+
+    m_file.clear();
+    m_nbFt   = 0;
+    m_nbRead = 0;
+}
+
+
+// Read the next line holding an example
+bool CDataStream::readLine(string& _strLine)
+{
+    while ( getline(m_file, _strLine) )
+    {
+        // Text following a '#' is ignored in sparse files
+        size_t comment = m_bSparse ? _strLine.find('#') : string::npos;
+        if (comment != string::npos)
+            _strLine.erase(comment);
+
+        _strLine = FileUtils::trim(_strLine);
+        if ( !_strLine.empty() )  // Skip empty lines
+            return true;
+    }
+
+    return false;
+}
+
+
+// Number of examples of a dataset file (the labels do not matter)
+long CDataStream::countExamples(const char* _sFilename)
+{
+    CDataStream stream;
+    if ( !stream.open(_sFilename) )
+        return -1;
+
+    long   nbEx = 0;
+    string strLine;
+
+    while ( stream.readLine(strLine) )
+        ++nbEx;
+
+    return nbEx;
+}
+
+
+// Read the next examples
+int CDataStream::read(CDataMatrix& _chunk, int _maxEx)
+{
+    vector<double>  labels;
+    vector<size_t>  rowStart(1, 0);
+    vector<int>     colIndex;
+    vector<double>  values;
+    int             maxIndex = 0;
+    int             nbEx = 0;
+
+    string strLine;
+    while ( nbEx < _maxEx && readLine(strLine) )
+    {
+        const char* pos = strLine.c_str();
+        char*       end;
+
+        if (m_bLabels)
+        {
+            labels.push_back( strtod(pos, &end) );
+            pos = end;
+        }
+
+        bool bValid = m_bSparse ? parseSparse(pos, colIndex, values, maxIndex)
+                                : parseDense(pos, values);
+
+        if ( !bValid )
+        {
+            cerr << "[CDataStream::read] Invalid example " << m_nbRead + nbEx + 1 << "." << endl;
+            return -1;
+        }
+
+        rowStart.push_back( colIndex.size() );
+        ++nbEx;
+    }
+
+    _chunk = CDataMatrix();
+    m_nbRead += nbEx;
+
+    if (nbEx == 0)
+        return 0;
+
+    if (m_bSparse)
+    {
+        _chunk.nbEx = nbEx;
+        _chunk.nbFt = maxIndex;
+
+        _chunk.S = new CSparseMatrix();
+        _chunk.S->init(nbEx, maxIndex, colIndex.size());
+
+        copy(rowStart.begin(), rowStart.end(), _chunk.S->rowStart);
+        copy(colIndex.begin(), colIndex.end(), _chunk.S->colIndex);
+        copy(values.begin(),   values.end(),   _chunk.S->values);
+
+        if (m_bLabels)
+            _chunk.Y = gsl_vector_alloc(nbEx);
+    }
+    else
+    {
+        _chunk.init(nbEx, m_nbFt, m_bLabels);
+        copy(values.begin(), values.end(), _chunk.X->data);
+
+        // Ternary features: kernels are computed from the bit-packed examples
+        if ( CTernaryMatrix::isTernary(_chunk.X) )
+            _chunk.T = CTernaryMatrix::pack(_chunk.X);
+    }
+
+    if (m_bLabels)
+        MathUtils::assign(_chunk.Y, labels);
+
+    return nbEx;
+}
+
+
+// Parse the features of a dense line: all of them have the number of features of the first one
+bool CDataStream::parseDense(const char* _pos, vector<double>& _values)
+{
+    int     nbFt = 0;
+    char*   end;
+
+    while (true)
+    {
+        double value = strtod(_pos, &end);
+        if (end == _pos)
+            break;
+
+        _values.push_back(value);
+        _pos = end;
+        ++nbFt;
+    }
+
+    if (m_nbFt == 0)
+        m_nbFt = nbFt;
+
+    return nbFt > 0 && nbFt == m_nbFt && *_pos == '\0';
+}
+
+
+// Parse the features of a sparse line: "index:value" pairs, indices starting at 1
+bool CDataStream::parseSparse(const char* _pos, vector<int>& _colIndex, vector<double>& _values,
+                              int& _maxIndex)
+{
+    char* end;
+
+    while (true)
+    {
+        long index = strtol(_pos, &end, 10);
+        if (end == _pos || *end != ':')
+            break;
+
+        double value = strtod(end+1, &end);
+        _pos = end;
+
+        if (index < 1)
+            return false;
+
+        if (value != 0.0)
+        {
+            _colIndex.push_back(index-1);
+            _values.push_back(value);
+            _maxIndex = max(_maxIndex, (int)index);
+        }
+    }
+
+    return true;
+}
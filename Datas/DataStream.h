@@ -0,0 +1,70 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+
+#ifndef DATA_STREAM_H
+#define DATA_STREAM_H
+
+#include "DataMatrix.h"
+
+#include <fstream>
+#include <string>
+
+// Dataset file read by chunks of examples, so that a file of any size is processed in constant
+// memory. The formats are the ones of CDataMatrix::loadFromFile: dense examples (each chunk is
+// also bit-packed when its features are ternary) or sparse ones, detected from the first line.
+// The sparse chunks have as many features as their largest index.
+class CDataStream
+{
+public:
+    // Constructor / Destructor (the cycle of life!)
+    CDataStream();
+    virtual ~CDataStream()  { close(); }
+
+    // Open a dataset file (first column contains labels if _bFirstColumnAsLabels==true)
+    bool        open(const char* _sFilename, bool _bFirstColumnAsLabels = true);
+    void        close();
+
+    // Read the next examples (at most _maxEx) into a new dataset, to be freed by the caller.
+    // Returns the number of examples read: 0 at the end of the file, -1 if a line is invalid.
+    int         read(CDataMatrix& _chunk, int _maxEx);
+
+    // Type of the examples, and number of examples read so far
+    bool        isSparse() const    { return m_bSparse; }
+    long        getNbRead() const   { return m_nbRead;  }
+
+    // Number of examples of a dataset file, from its lines (without parsing them), -1 if the
+    // file can not be opened
+    static long countExamples(const char* _sFilename);
+
+private:
+    // Read the next line holding an example (false at the end of the file)
+    bool        readLine(std::string& _strLine);
+
+    // Parse the features of a line, from _pos (false if the line is invalid)
+    bool        parseDense(const char* _pos, std::vector<double>& _values);
+    bool        parseSparse(const char* _pos, std::vector<int>& _colIndex, std::vector<double>& _values,
+                            int& _maxIndex);
+
+    std::ifstream   m_file;
+    bool            m_bLabels;
+    bool            m_bSparse;
+    int             m_nbFt;     // Number of features of the dense examples (from the first line)
+    long            m_nbRead;
+};
+
+#endif // DATA_STREAM_H
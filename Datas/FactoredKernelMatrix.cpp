@@ -0,0 +1,288 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+#include "FactoredKernelMatrix.h"
+#include "Utils/MathUtils.h"
+
+#include <gsl/gsl_blas.h>
+
+
+// Constructor
+CFactoredKernelMatrix::CFactoredKernelMatrix(const CDataMatrix& _A)
+: CKernelMatrix()
+{
+    m_A  = _A;
+
+    Y    = _A.Y;
+    nbEx = _A.nbEx;
+    nbFt = _A.nbEx+1;
+
+    int rank = _A.nbFt;
+
+    m_AG       = gsl_matrix_alloc(nbEx, rank);
+    m_vSumA    = gsl_vector_alloc(rank);
+    m_vColSums = gsl_vector_alloc(nbEx);
+    computeProducts();
+
+    m_cols    = gsl_matrix_alloc(2, nbEx);
+    m_nextCol = 0;
+
+    m_pTracked    = NULL;
+    m_vU          = gsl_vector_calloc(rank);
+    m_vZ          = gsl_vector_calloc(rank);
+    m_sum         = 0.0;
+    m_pendingBias = 0.0;
+}
+
+
+// Compute A*G, A'*W and K*W (W = 1 without rows weights)
+void CFactoredKernelMatrix::computeProducts()
+{
+    int rank = m_A.nbFt;
+
+    // Rows of A scaled by their weight: diag(W)*A
+    gsl_matrix* WA = m_A.X;
+    if (W != NULL)
+    {
+        WA = gsl_matrix_alloc(nbEx, rank);
+        gsl_matrix_memcpy(WA, m_A.X);
+
+        for (int i = 0; i < nbEx; ++i)
+        {
+            gsl_vector row = gsl_matrix_row(WA, i).vector;
+            gsl_vector_scale(&row, gsl_vector_get(W, i));
+        }
+    }
+
+    // A*G = A*(A'*WA) = (A*A')*WA, in the cheapest order: O(n*r^2) or O(n^2*r)
+    if (rank <= nbEx)
+    {
+        gsl_matrix* G = gsl_matrix_alloc(rank, rank);
+        MathUtils::matrixProduct(G, m_A.X, WA, true, false);
+        MathUtils::matrixProduct(m_AG, m_A.X, G);
+        gsl_matrix_free(G);
+    }
+    else
+    {
+        gsl_matrix* K = gsl_matrix_alloc(nbEx, nbEx);
+        MathUtils::matrixProduct(K, m_A.X, m_A.X, false, true);
+        MathUtils::matrixProduct(m_AG, K, WA);
+        gsl_matrix_free(K);
+    }
+
+    // A'*W = WA'*1, then K*W = A*(A'*W)
+    gsl_vector* vOnes = gsl_vector_alloc(nbEx);
+    gsl_vector_set_all(vOnes, 1.0);
+
+    MathUtils::mvProduct(m_vSumA, WA, vOnes, true);
+    MathUtils::mvProduct(m_vColSums, m_A.X, m_vSumA);
+    m_sumW = (W != NULL) ? MathUtils::sum(W) : nbEx;
+
+    gsl_vector_free(vOnes);
+
+    if (WA != m_A.X)
+        gsl_matrix_free(WA);
+}
+
+
+// Rows weights: the products are computed again, and the tracked vector represented again
+void CFactoredKernelMatrix::setRowWeights(gsl_vector* _W)
+{
+    gsl_vector* pTracked = m_pTracked;
+    trackVector(NULL);
+
+    W = _W;
+    computeProducts();
+
+    trackVector(pTracked);
+}
+
+
+// Desallocate memory (including the factor matrix)
+void CFactoredKernelMatrix::free()
+{
+    flushTrackedVector();
+    m_pTracked = NULL;
+
+    if (m_AG != NULL)       gsl_matrix_free(m_AG);
+    if (m_vSumA != NULL)    gsl_vector_free(m_vSumA);
+    if (m_vColSums != NULL) gsl_vector_free(m_vColSums);
+    if (m_cols != NULL)     gsl_matrix_free(m_cols);
+    if (m_vU != NULL)       gsl_vector_free(m_vU);
+    if (m_vZ != NULL)       gsl_vector_free(m_vZ);
+
+    m_AG       = NULL;
+    m_vSumA    = NULL;
+    m_vColSums = NULL;
+    m_cols     = NULL;
+    m_vU       = NULL;
+    m_vZ       = NULL;
+
+    m_A.free();
+    Y = NULL;
+}
+
+
+// Get a whole matrix column: K[:,j] = A*a_j
+gsl_vector CFactoredKernelMatrix::getCol(int _j)
+{
+    gsl_vector col = gsl_matrix_row(m_cols, m_nextCol).vector;
+    m_nextCol = 1 - m_nextCol;
+
+    if (_j == nbEx)
+    {
+        gsl_vector_set_all(&col, 1.0);   // bias
+    }
+    else
+    {
+        gsl_vector a = m_A.getRow(_j);
+        MathUtils::mvProduct(&col, m_A.X, &a);
+    }
+
+    return col;
+}
+
+
+// Dot product between a column and a vector
+double CFactoredKernelMatrix::colDot(int _j, gsl_vector* _v)
+{
+    if (_v != m_pTracked)
+        return CKernelMatrix::colDot(_j, _v);
+
+    if (_j == nbEx)
+        return m_sum;
+
+    gsl_vector a = m_A.getRow(_j);
+    return MathUtils::dot(&a, m_vU);
+}
+
+
+// Add a multiple of a column to a vector (deferred for the tracked vector)
+void CFactoredKernelMatrix::colAxpy(int _j, double _factor, gsl_vector* _v)
+{
+    if (_v != m_pTracked)
+    {
+        CKernelMatrix::colAxpy(_j, _factor, _v);
+        return;
+    }
+
+    if (_j == nbEx)
+    {
+        // A'*1 = sumA,  1'*1 = n
+        MathUtils::add(m_vU, m_vSumA, _factor);
+        m_sum         += _factor * m_sumW;
+        m_pendingBias += _factor;
+    }
+    else
+    {
+        // A'*(A*a_j) = G*a_j,  1'*(A*a_j) = sum of column j
+        gsl_vector a  = m_A.getRow(_j);
+        gsl_vector ag = gsl_matrix_row(m_AG, _j).vector;
+
+        MathUtils::add(m_vU, &ag, _factor);
+        m_sum += _factor * gsl_vector_get(m_vColSums, _j);
+        MathUtils::add(m_vZ, &a, _factor);
+    }
+}
+
+
+// Sum of the squared elements of a column
+double CFactoredKernelMatrix::colSqrNorm(int _j)
+{
+    return colColDot(_j, _j);
+}
+
+
+// Dot product between two columns
+double CFactoredKernelMatrix::colColDot(int _i, int _j)
+{
+    if (_i == nbEx && _j == nbEx)
+        return m_sumW;
+
+    if (_i == nbEx || _j == nbEx)
+        return gsl_vector_get(m_vColSums, _i == nbEx ? _j : _i);
+
+    gsl_vector a  = m_A.getRow(_j);
+    gsl_vector ag = gsl_matrix_row(m_AG, _i).vector;
+
+    return MathUtils::dot(&ag, &a);
+}
+
+
+// Matrix by vector product, through the factor
+void CFactoredKernelMatrix::mvProduct(gsl_vector* _ptrVector, gsl_vector* _w)
+{
+    gsl_vector  w  = gsl_vector_subvector(_w, 0, nbEx).vector;
+    gsl_vector* vT = gsl_vector_alloc(m_A.nbFt);
+
+    MathUtils::mvProduct(vT, m_A.X, &w, true);
+    MathUtils::mvProduct(_ptrVector, m_A.X, vT);
+    MathUtils::add(_ptrVector, gsl_vector_get(_w, nbEx));
+
+    gsl_vector_free(vT);
+}
+
+
+// Weights on the factor features: K*w = A*(A'*w[0..n-1]) + w[n]
+void CFactoredKernelMatrix::primalWeights(gsl_vector* _w, gsl_vector* _primal)
+{
+    gsl_vector w      = gsl_vector_subvector(_w, 0, nbEx).vector;
+    gsl_vector primal = gsl_vector_subvector(_primal, 0, m_A.nbFt).vector;
+
+    MathUtils::mvProduct(&primal, m_A.X, &w, true);
+    gsl_vector_set(_primal, m_A.nbFt, gsl_vector_get(_w, nbEx));
+}
+
+
+// Track a vector (NULL to stop tracking): the pending updates of the previous one are applied
+void CFactoredKernelMatrix::trackVector(gsl_vector* _v)
+{
+    flushTrackedVector();
+
+    m_pTracked = _v;
+
+    if (_v != NULL)
+    {
+        if (W != NULL)
+        {
+            gsl_vector* vWV = gsl_vector_alloc(nbEx);
+            MathUtils::multiply(vWV, _v, W);
+            MathUtils::mvProduct(m_vU, m_A.X, vWV, true);
+            m_sum = MathUtils::sum(vWV);
+            gsl_vector_free(vWV);
+        }
+        else
+        {
+            MathUtils::mvProduct(m_vU, m_A.X, _v, true);
+            m_sum = MathUtils::sum(_v);
+        }
+    }
+}
+
+
+// Apply the pending updates of the tracked vector: v += A*z + bias*1
+void CFactoredKernelMatrix::flushTrackedVector()
+{
+    if (m_pTracked == NULL)
+        return;
+
+    gsl_blas_dgemv(CblasNoTrans, 1.0, m_A.X, m_vZ, 1.0, m_pTracked);
+    MathUtils::add(m_pTracked, m_pendingBias);
+
+    gsl_vector_set_zero(m_vZ);
+    m_pendingBias = 0.0;
+}
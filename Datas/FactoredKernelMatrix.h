@@ -0,0 +1,96 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+#ifndef FACTORED_KERNEL_MATRIX_H
+#define FACTORED_KERNEL_MATRIX_H
+
+#include "KernelMatrix.h"
+
+#include <gsl/gsl_matrix.h>
+#include <gsl/gsl_vector.h>
+
+// Training kernel matrix given by a factor A of rank r:  K = A * A' (plus the bias column).
+// The matrix is never formed: memory is O(n*r), and each column operation used by the
+// learners on the tracked vector (see CKernelMatrix::trackVector) costs O(r) instead of O(n):
+//  - the tracked vector v is represented by u = A'*v and by the sum of its elements
+//  - its updates v += f * K[:,j] = f * A*a_j are accumulated in the factor space (z += f * a_j)
+//    and applied by flushTrackedVector() only (v += A*z)
+// Rows of A*G (with G = A'*A) give the dot products between columns: K[:,i]*K[:,j] = a_i' G a_j.
+// With rows weights (see CKernelMatrix::W), u = A'*(W.v) and G = A'*diag(W)*A instead.
+class CFactoredKernelMatrix : public CKernelMatrix
+{
+public:
+    // Constructor / Destructor (the cycle of life!)
+    // _A : factor matrix [nb examples]x[rank] with the labels vector (freed by free())
+    CFactoredKernelMatrix(const CDataMatrix& _A);
+    virtual ~CFactoredKernelMatrix()    { }
+
+    // Desallocate memory
+    virtual void        free();
+
+    // Get a whole matrix column (computed in one of two buffers)
+    virtual gsl_vector  getCol(int _j);
+
+    // Operations on a column (in O(r) when they involve the tracked vector)
+    virtual double      colDot(int _j, gsl_vector* _v);
+    virtual void        colAxpy(int _j, double _factor, gsl_vector* _v);
+    virtual double      colSqrNorm(int _j);
+    virtual double      colColDot(int _i, int _j);
+
+    // Matrix by vector product: _ptrVector = A * (A' * _w) + bias
+    virtual void        mvProduct(gsl_vector* _ptrVector, gsl_vector* _w);
+
+    // Rows weights (the products above are computed again)
+    virtual void        setRowWeights(gsl_vector* _W);
+
+    // Tracked vector (see CKernelMatrix)
+    virtual void        trackVector(gsl_vector* _v);
+    virtual void        flushTrackedVector();
+
+    // Rank of the factorization
+    int                 getRank() const     { return m_A.nbFt; }
+
+    // Weights of a linear classifier on the factor features (primal weights), equivalent
+    // to the weights _w on the matrix columns:  _primal = [A'*w[0..n-1], w[n]]  (size rank+1)
+    void                primalWeights(gsl_vector* _w, gsl_vector* _primal);
+
+protected:
+    // Compute A*G, A'*W and K*W (W = 1 without rows weights)
+    void                computeProducts();
+
+    // Factor A (one row a_i by example) and A*G
+    CDataMatrix         m_A;
+    gsl_matrix*         m_AG;
+
+    // A'*W, sums of the kernel matrix columns (K*W) and sum of the rows weights
+    gsl_vector*         m_vSumA;
+    gsl_vector*         m_vColSums;
+    double              m_sumW;
+
+    // Buffers returned by getCol
+    gsl_matrix*         m_cols;
+    int                 m_nextCol;
+
+    // Tracked vector v: u = A'*v, sum(v), and the pending updates (v += A*z + bias*1)
+    gsl_vector*         m_pTracked;
+    gsl_vector*         m_vU;
+    double              m_sum;
+    gsl_vector*         m_vZ;
+    double              m_pendingBias;
+};
+
+#endif // FACTORED_KERNEL_MATRIX_H
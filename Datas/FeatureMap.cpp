@@ -0,0 +1,63 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+#include "FeatureMap.h"
+#include "RandomFeatures.h"
+#include "KernelFeatures.h"
+
+#include <stdexcept>
+
+using namespace std;
+
+
+// Create the feature map asked by the parameters
+CFeatureMap* CFeatureMap::create(const StrValueMap& _map, CKernel _kernel)
+{
+    StrValueMap::const_iterator it;
+
+    if ( (it = _map.find("rff.D")) != _map.end() && (int)it->second > 0 )
+        return new CRandomFeatures(_map, _kernel);
+
+    if ( (it = _map.find("factored")) != _map.end() && (bool)it->second && CKernelFeatures::isSupported(_kernel) )
+        return new CKernelFeatures(_kernel);
+
+    return NULL;
+}
+
+
+// Map a dataset into the features space
+CDataMatrix CFeatureMap::transform(const CDataMatrix& _X, bool _bBias /*= false*/)
+{
+    if ( _X.isSparse() )
+        throw logic_error("[CFeatureMap::transform] Sparse features are not supported.");
+
+    int nbFeatures = getNbFeatures(_X.nbFt);
+
+    CDataMatrix Z;
+    Z.init(_X.nbEx, nbFeatures + (_bBias ? 1 : 0), (_X.Y != NULL));
+
+    gsl_matrix_view features = gsl_matrix_submatrix(Z.X, 0, 0, _X.nbEx, nbFeatures);
+    fill(_X, &features.matrix);
+
+    if (_bBias)
+        Z.setCol(nbFeatures, 1.0);
+
+    if (_X.Y != NULL)
+        gsl_vector_memcpy(Z.Y, _X.Y);
+
+    return Z;
+}
@@ -0,0 +1,62 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+#ifndef FEATURE_MAP_H
+#define FEATURE_MAP_H
+
+#include "DataMatrix.h"
+#include "Kernel.h"
+#include "Utils/StrValue.h"
+
+#include <gsl/gsl_matrix.h>
+#include <string>
+
+// Explicit feature map z of a kernel:  k(x,y) = z(x)*z(y)  (exactly or approximately).
+// The training kernel matrix is then factored (K = Z*Z', see CFactoredKernelMatrix) and the
+// classifier holds one weight by feature (see CFactoredKernelMatrix::primalWeights), so that
+// classifying an example costs a single dot product in the features space.
+class CFeatureMap
+{
+public:
+    // Constructor / Destructor (the cycle of life!)
+    CFeatureMap()           { }
+    virtual ~CFeatureMap()  { }
+
+    // Create the feature map asked by the parameters (NULL if none):
+    //  - rff.D > 0     : random Fourier features of the RBF kernel (see CRandomFeatures)
+    //  - factored = 1  : exact features of the LINEAR and POLY kernels (see CKernelFeatures),
+    //                    none for the other kernels (see CKernelFeatures::isSupported)
+    // The parameters can be the user ones or the ones saved in a model file by serialize().
+    static CFeatureMap* create(const StrValueMap& _map, CKernel _kernel);
+
+    // Allow to save and reconstruct the feature map (with the kernel parameters)
+    virtual StrValueMap serialize() = 0;
+
+    // Description and number of features for inputs of dimension _nbInputs
+    virtual std::string getName() = 0;
+    virtual int         getNbFeatures(int _nbInputs) = 0;
+
+    // Map a dataset into the features space (labels are copied). If _bBias==true, a last
+    // column of ones is added (the examples are then ready for a primal linear classifier).
+    CDataMatrix         transform(const CDataMatrix& _X, bool _bBias = false);
+
+protected:
+    // Fill the features of each example:  _Z[i,:] = z( _X[i,:] )
+    virtual void        fill(const CDataMatrix& _X, gsl_matrix* _Z) = 0;
+};
+
+#endif // FEATURE_MAP_H
@@ -0,0 +1,146 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+
+#include "FloatKernelMatrix.h"
+
+#include <algorithm>
+
+using namespace std;
+
+// Number of columns computed at once (in double precision)
+#define FLOAT_KERNEL_TILE_SIZE 256
+
+
+// Constructor: computes the matrix one tile of columns at the time
+CFloatKernelMatrix::CFloatKernelMatrix(const CDataMatrix& _data, const CKernel& _kernel)
+: CImplicitBiasKernelMatrix()
+{
+    CKernel kernel = _kernel;
+
+    Y    = _data.Y;
+    setSize(_data.nbEx);
+
+    m_values  = new float[(size_t)nbEx*nbEx];
+    m_cols    = gsl_matrix_alloc(2, nbEx);
+    m_nextCol = 0;
+
+    gsl_matrix* tile = gsl_matrix_alloc(min(FLOAT_KERNEL_TILE_SIZE, nbEx), nbEx);
+
+    for (int j0 = 0; j0 < nbEx; j0 += FLOAT_KERNEL_TILE_SIZE)
+    {
+        int nbCols = min(FLOAT_KERNEL_TILE_SIZE, nbEx - j0);
+
+        gsl_matrix_view cols = gsl_matrix_submatrix(tile, 0, 0, nbCols, nbEx);
+        kernel.fillKernelRows(_data, j0, nbCols, &cols.matrix);
+
+        for (int j = 0; j < nbCols; ++j)
+        {
+            const double* src = gsl_matrix_const_ptr(tile, j, 0);
+            copy(src, src + nbEx, m_values + (size_t)(j0+j)*nbEx);
+        }
+    }
+
+    gsl_matrix_free(tile);
+}
+
+
+// Desallocate memory (the training examples are not owned by this object)
+void CFloatKernelMatrix::free()
+{
+    CImplicitBiasKernelMatrix::free();
+
+    delete[] m_values;
+    if (m_cols != NULL) gsl_matrix_free(m_cols);
+
+    m_values = NULL;
+    m_cols   = NULL;
+    Y        = NULL;
+}
+
+
+// Get a kernel column
+gsl_vector CFloatKernelMatrix::getKernelCol(int _j)
+{
+    gsl_vector buffer = gsl_matrix_row(m_cols, m_nextCol).vector;
+    m_nextCol = 1 - m_nextCol;
+
+    copy(col(_j), col(_j) + nbEx, buffer.data);
+    return buffer;
+}
+
+
+// Dot product between a kernel column and a vector
+double CFloatKernelMatrix::kernelColDot(int _j, gsl_vector* _v)
+{
+    const double* v      = _v->data;
+    size_t        stride = _v->stride;
+    const float*  k      = col(_j);
+    double        result = 0.0;
+
+    for (int i = 0; i < nbEx; ++i)
+        result += k[i] * v[i*stride];
+
+    return result;
+}
+
+
+// Add a multiple of a kernel column to a vector
+void CFloatKernelMatrix::kernelColAxpy(int _j, double _factor, gsl_vector* _v)
+{
+    double*      v      = _v->data;
+    size_t       stride = _v->stride;
+    const float* k      = col(_j);
+
+    for (int i = 0; i < nbEx; ++i)
+        v[i*stride] += _factor * k[i];
+}
+
+
+// Sum of the elements of a kernel column
+double CFloatKernelMatrix::kernelColSum(int _j)
+{
+    const float* k      = col(_j);
+    double       result = 0.0;
+
+    for (int i = 0; i < nbEx; ++i)
+        result += k[i];
+
+    return result;
+}
+
+
+// Dot product between two kernel columns
+double CFloatKernelMatrix::kernelColColDot(int _i, int _j)
+{
+    const float* k1     = col(_i);
+    const float* k2     = col(_j);
+    double       result = 0.0;
+
+    for (int i = 0; i < nbEx; ++i)
+        result += (double)k1[i] * k2[i];
+
+    return result;
+}
+
+
+// Add the product of the kernel columns by _w (K is symmetric: row i is column i)
+void CFloatKernelMatrix::kernelMvProduct(gsl_vector* _ptrVector, gsl_vector* _w)
+{
+    for (int i = 0; i < nbEx; ++i)
+        *gsl_vector_ptr(_ptrVector, i) += kernelColDot(i, _w);
+}
@@ -0,0 +1,67 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+
+#ifndef FLOAT_KERNEL_MATRIX_H
+#define FLOAT_KERNEL_MATRIX_H
+
+#include "KernelMatrix.h"
+#include "Kernel.h"
+
+#include <gsl/gsl_matrix.h>
+#include <gsl/gsl_vector.h>
+
+// Training kernel matrix (train vs train, plus the bias column) stored in single precision:
+// half the memory of a dense matrix, and half the memory traffic of the column operations.
+// Kernel values are computed in double precision, then rounded. The column operations
+// accumulate in double precision, into the double precision vectors of the learners.
+class CFloatKernelMatrix : public CImplicitBiasKernelMatrix
+{
+public:
+    // Constructor / Destructor (the cycle of life!)
+    CFloatKernelMatrix(const CDataMatrix& _data, const CKernel& _kernel);
+    virtual ~CFloatKernelMatrix()   { }
+
+    // Desallocate memory
+    virtual void        free();
+
+    // Memory used by the matrix values, in bytes
+    size_t              getSize() const     { return (size_t)nbEx*nbEx*sizeof(float); }
+
+protected:
+    // Get a kernel column (converted in one of two buffers)
+    virtual gsl_vector  getKernelCol(int _j);
+
+    // Operations on a kernel column, read in single precision
+    virtual double      kernelColDot(int _j, gsl_vector* _v);
+    virtual void        kernelColAxpy(int _j, double _factor, gsl_vector* _v);
+    virtual double      kernelColSum(int _j);
+    virtual double      kernelColColDot(int _i, int _j);
+    virtual void        kernelMvProduct(gsl_vector* _ptrVector, gsl_vector* _w);
+
+    // Column j of the matrix (j < nbEx)
+    const float*        col(int _j) const   { return m_values + (size_t)_j*nbEx; }
+
+    // Matrix values without the bias column (the matrix is symmetric: column j is row j)
+    float*              m_values;
+
+    // Buffers returned by getCol
+    gsl_matrix*         m_cols;
+    int                 m_nextCol;
+};
+
+#endif // FLOAT_KERNEL_MATRIX_H
@@ -0,0 +1,271 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+
+#include "GammaSelector.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+
+using namespace std;
+
+// Grid of gamma values: median heuristic value times 2^k, for k in [-GRID_RANGE, GRID_RANGE]
+// by steps of GRID_STEP, then golden section refinement around the best one
+#define GAMMA_GRID_RANGE    10.0
+#define GAMMA_GRID_STEP     0.5
+#define GAMMA_GOLDEN_ITER   20
+
+
+// Constructor
+CGammaSelector::CGammaSelector(const CKernel& _kernel, int _nbSamples, int _nbSubsets, unsigned long _seed)
+{
+    m_kernel      = _kernel;
+    m_nbSamples   = _nbSamples;
+    m_nbSubsets   = _nbSubsets;
+    m_seed        = _seed;
+    m_bTwoClasses = false;
+    m_medianGamma = 0.0;
+    m_bAligned    = false;
+
+    if (m_nbSamples < 2 || m_nbSubsets < 1)
+        throw logic_error("[CGammaSelector::CGammaSelector] At least one subsample of two examples is needed.");
+}
+
+
+// Desallocate memory
+void CGammaSelector::free()
+{
+    for (size_t s = 0; s < m_sqrDists.size(); ++s)
+    {
+        gsl_matrix_free(m_sqrDists[s]);
+        gsl_vector_free(m_labels[s]);
+    }
+
+    m_sqrDists.clear();
+    m_labels.clear();
+}
+
+
+// Select gamma for a dataset
+double CGammaSelector::select(const CDataMatrix& _X)
+{
+    if (_X.Y == NULL || _X.nbEx < 2)
+        throw logic_error("[CGammaSelector::select] At least two labeled examples are needed.");
+
+    gsl_rng* rng = gsl_rng_alloc(gsl_rng_mt19937);
+    gsl_rng_set(rng, m_seed);
+
+    free();
+    drawSubsets(_X, rng);
+    gsl_rng_free(rng);
+
+    double median = medianSqrDist();
+    m_medianGamma = (median > 0) ? 1.0 / median : 1.0;
+    m_bAligned    = false;
+
+    m_grid.clear();
+    m_alignments.clear();
+
+    if (!m_bTwoClasses)
+        return m_medianGamma;
+
+    // Grid search on log2(gamma)
+    double center = log2(m_medianGamma);
+    int    iBest  = 0;
+
+    for (double k = -GAMMA_GRID_RANGE; k <= GAMMA_GRID_RANGE; k += GAMMA_GRID_STEP)
+    {
+        m_grid.push_back( pow(2.0, center + k) );
+        m_alignments.push_back( alignment(m_grid.back()) );
+
+        if (m_alignments.back() > m_alignments[iBest])
+            iBest = m_alignments.size() - 1;
+    }
+
+    // A maximum on the border is not reliable (the alignment may keep increasing)
+    if (iBest == 0 || iBest == (int)m_grid.size()-1)
+        return m_medianGamma;
+
+    // Golden section search between the neighbors of the best grid value
+    const double ratio = (sqrt(5.0) - 1) / 2;
+    double a = log2(m_grid[iBest-1]);
+    double b = log2(m_grid[iBest+1]);
+    double x1 = b - ratio*(b-a),  f1 = alignment( pow(2.0, x1) );
+    double x2 = a + ratio*(b-a),  f2 = alignment( pow(2.0, x2) );
+
+    for (int iter = 0; iter < GAMMA_GOLDEN_ITER; ++iter)
+    {
+        if (f1 > f2)
+        {
+            b  = x2;
+            x2 = x1;  f2 = f1;
+            x1 = b - ratio*(b-a);
+            f1 = alignment( pow(2.0, x1) );
+        }
+        else
+        {
+            a  = x1;
+            x1 = x2;  f1 = f2;
+            x2 = a + ratio*(b-a);
+            f2 = alignment( pow(2.0, x2) );
+        }
+    }
+
+    m_bAligned = true;
+    return pow(2.0, (a+b)/2);
+}
+
+
+// Average kernel-target alignment:  sum_ij y_i y_j K_ij / (m * sqrt(sum_ij K_ij^2)),
+// with K_ij = exp(-gamma D_ij)
+double CGammaSelector::alignment(double _gamma) const
+{
+    double result = 0.0;
+
+    for (size_t s = 0; s < m_sqrDists.size(); ++s)
+    {
+        const gsl_matrix* D = m_sqrDists[s];
+        const gsl_vector* y = m_labels[s];
+        int               m = D->size1;
+
+        double target = 0.0;
+        double sqrNorm = 0.0;
+
+        #pragma omp parallel for reduction(+:target,sqrNorm) num_threads(m_kernel.getNbThreads())
+        for (int i = 0; i < m; ++i)
+        {
+            const double* dist = gsl_matrix_const_ptr(D, i, 0);
+            double        y_i  = gsl_vector_get(y, i);
+
+            for (int j = 0; j < m; ++j)
+            {
+                double k = exp( -1 * _gamma * dist[j] );
+                target  += y_i * gsl_vector_get(y, j) * k;
+                sqrNorm += k * k;
+            }
+        }
+
+        result += target / (m * sqrt(sqrNorm));
+    }
+
+    return result / m_sqrDists.size();
+}
+
+
+// Draw the subsamples (m distinct random examples each, partial Fisher-Yates shuffle)
+void CGammaSelector::drawSubsets(const CDataMatrix& _X, gsl_rng* _rng)
+{
+    int m = min(m_nbSamples, _X.nbEx);
+
+    // A subsample of the whole dataset is the dataset itself
+    int nbSubsets = (m == _X.nbEx) ? 1 : m_nbSubsets;
+
+    vector<int> indices(_X.nbEx);
+    for (int i = 0; i < _X.nbEx; ++i)
+        indices[i] = i;
+
+    m_bTwoClasses = true;
+
+    for (int s = 0; s < nbSubsets; ++s)
+    {
+        for (int k = 0; k < m; ++k)
+            swap( indices[k], indices[ k + gsl_rng_uniform_int(_rng, _X.nbEx-k) ] );
+
+        sort(indices.begin(), indices.begin() + m);
+
+        // Subsample as a dataset
+        CDataMatrix subset;
+        subset.nbEx = m;
+        subset.nbFt = _X.nbFt;
+        subset.Y    = gsl_vector_alloc(m);
+
+        if ( _X.isSparse() )
+        {
+            size_t nbNonZeros = 0;
+            for (int k = 0; k < m; ++k)
+                nbNonZeros += _X.S->getRowSize( indices[k] );
+
+            subset.S = new CSparseMatrix();
+            subset.S->init(m, _X.nbFt, nbNonZeros);
+
+            size_t pos = 0;
+            for (int k = 0; k < m; ++k)
+            {
+                for (size_t l = _X.S->rowStart[indices[k]]; l < _X.S->rowStart[indices[k]+1]; ++l, ++pos)
+                {
+                    subset.S->colIndex[pos] = _X.S->colIndex[l];
+                    subset.S->values[pos]   = _X.S->values[l];
+                }
+                subset.S->rowStart[k+1] = pos;
+            }
+        }
+        else
+        {
+            subset.X = gsl_matrix_alloc(m, _X.nbFt);
+            for (int k = 0; k < m; ++k)
+            {
+                gsl_vector x = _X.getRow( indices[k] );
+                gsl_matrix_set_row(subset.X, k, &x);
+            }
+        }
+
+        bool bPositive = false, bNegative = false;
+        for (int k = 0; k < m; ++k)
+        {
+            double y = _X.getY( indices[k] );
+            gsl_vector_set(subset.Y, k, y);
+            bPositive = bPositive || (y > 0);
+            bNegative = bNegative || (y < 0);
+        }
+
+        m_bTwoClasses = m_bTwoClasses && bPositive && bNegative;
+
+        gsl_matrix* D = gsl_matrix_alloc(m, m);
+        m_kernel.fillSqrDistMatrix(subset, subset, D);
+
+        m_sqrDists.push_back(D);
+        m_labels.push_back( gsl_vector_alloc(m) );
+        gsl_vector_memcpy(m_labels.back(), subset.Y);
+
+        subset.free();
+    }
+}
+
+
+// Median of the squared distances between distinct examples
+double CGammaSelector::medianSqrDist() const
+{
+    vector<double> dists;
+
+    for (size_t s = 0; s < m_sqrDists.size(); ++s)
+    {
+        const gsl_matrix* D = m_sqrDists[s];
+
+        for (size_t i = 0; i < D->size1; ++i)
+        {
+            for (size_t j = i+1; j < D->size2; ++j)
+                dists.push_back( max(gsl_matrix_get(D, i, j), 0.0) );
+        }
+    }
+
+    if ( dists.empty() )
+        return 0.0;
+
+    nth_element(dists.begin(), dists.begin() + dists.size()/2, dists.end());
+    return dists[ dists.size()/2 ];
+}
@@ -0,0 +1,85 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+
+#ifndef GAMMA_SELECTOR_H
+#define GAMMA_SELECTOR_H
+
+#include "Kernel.h"
+
+#include <gsl/gsl_matrix.h>
+#include <gsl/gsl_rng.h>
+#include <vector>
+
+// Selection of the gamma parameter of the RBF kernel without learning, from the squared distances
+// between the examples of a few random subsamples of the training set (m examples each):
+//  - kernel-target alignment:  A(gamma) = <K, yy'> / (||K|| ||yy'||),  averaged over the
+//    subsamples, is maximized over log(gamma) (grid search around the median heuristic value,
+//    then golden section refinement)
+//  - median heuristic:  gamma = 1 / median of the squared distances. It is used instead when the
+//    alignment is not informative (a single class in a subsample, or a maximum on the grid border)
+// Time is O(nbSubsets * m^2) by evaluation of A, whatever the size of the training set.
+class CGammaSelector
+{
+public:
+    // Constructor / Destructor (the cycle of life!)
+    // _nbSamples : examples by subsample (at most the number of examples)
+    // _nbSubsets : number of subsamples
+    CGammaSelector(const CKernel& _kernel, int _nbSamples, int _nbSubsets, unsigned long _seed);
+    ~CGammaSelector()   { }
+
+    // Desallocate memory
+    void        free();
+
+    // Select gamma for a dataset (labels -1/+1)
+    double      select(const CDataMatrix& _X);
+
+    // Results of the last selection: median heuristic value, and whether the alignment was used
+    double      getMedianGamma() const  { return m_medianGamma; }
+    bool        isAligned() const       { return m_bAligned; }
+
+    // Average kernel-target alignment of a gamma value (on the subsamples of the last selection)
+    double      alignment(double _gamma) const;
+
+    // Grid of gamma values examined by the last selection, and their alignments
+    const std::vector<double>&  getGrid() const         { return m_grid; }
+    const std::vector<double>&  getAlignments() const   { return m_alignments; }
+
+private:
+    // Draw the subsamples and compute their squared distances matrices
+    void        drawSubsets(const CDataMatrix& _X, gsl_rng* _rng);
+
+    // Median of the squared distances between distinct examples of the subsamples
+    double      medianSqrDist() const;
+
+    CKernel                     m_kernel;
+    int                         m_nbSamples;
+    int                         m_nbSubsets;
+    unsigned long               m_seed;
+
+    // Squared distances matrix and labels of each subsample
+    std::vector<gsl_matrix*>    m_sqrDists;
+    std::vector<gsl_vector*>    m_labels;
+    bool                        m_bTwoClasses;
+
+    double                      m_medianGamma;
+    bool                        m_bAligned;
+    std::vector<double>         m_grid;
+    std::vector<double>         m_alignments;
+};
+
+#endif // GAMMA_SELECTOR_H
@@ -0,0 +1,149 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+
+#include "KdTree.h"
+
+#include <algorithm>
+
+using namespace std;
+
+
+// Orders row indexes by one coordinate
+struct CoordLess
+{
+    const gsl_matrix* X;
+    int               dim;
+
+    CoordLess(const gsl_matrix* _X, int _dim) : X(_X), dim(_dim) { }
+    bool operator()(int _i, int _j) const
+        { return gsl_matrix_get(X, _i, dim) < gsl_matrix_get(X, _j, dim); }
+};
+
+
+// Constructor: builds the tree
+CKdTree::CKdTree(const gsl_matrix* _X, int _leafSize /*= 16*/)
+{
+    m_X        = _X;
+    m_leafSize = max(_leafSize, 1);
+
+    m_perm.resize(_X->size1);
+    for (size_t i = 0; i < _X->size1; ++i)
+        m_perm[i] = i;
+
+    if ( !m_perm.empty() )
+        build(0, m_perm.size());
+}
+
+
+// Build the subtree of points m_perm[_first.._last) and return its node index
+int CKdTree::build(int _first, int _last)
+{
+    int index = m_nodes.size();
+    m_nodes.push_back(SNode());
+
+    SNode node;
+    node.first = _first;
+    node.last  = _last;
+    node.dim   = 0;
+    node.split = 0.0;
+    node.left  = -1;
+    node.right = -1;
+
+    if (_last - _first > m_leafSize)
+    {
+        // Dimension of largest spread
+        double maxSpread = 0.0;
+        for (size_t d = 0; d < m_X->size2; ++d)
+        {
+            double lo = gsl_matrix_get(m_X, m_perm[_first], d);
+            double hi = lo;
+            for (int k = _first+1; k < _last; ++k)
+            {
+                double v = gsl_matrix_get(m_X, m_perm[k], d);
+                lo = min(lo, v);
+                hi = max(hi, v);
+            }
+
+            if (hi - lo > maxSpread)
+            {
+                maxSpread = hi - lo;
+                node.dim  = d;
+            }
+        }
+
+        // Identical points remain in a leaf
+        if (maxSpread > 0.0)
+        {
+            int mid = (_first + _last) / 2;
+            nth_element(m_perm.begin() + _first, m_perm.begin() + mid, m_perm.begin() + _last,
+                        CoordLess(m_X, node.dim));
+            node.split = gsl_matrix_get(m_X, m_perm[mid], node.dim);
+
+            node.left  = build(_first, mid);
+            node.right = build(mid, _last);
+        }
+    }
+
+    m_nodes[index] = node;
+    return index;
+}
+
+
+// Points within a radius of x
+void CKdTree::radiusSearch(const double* _x, double _sqrRadius,
+                           std::vector<int>& _indexes, std::vector<double>& _sqrDists) const
+{
+    if ( !m_nodes.empty() )
+        search(0, _x, _sqrRadius, _indexes, _sqrDists);
+}
+
+
+// Search a subtree: the far child is visited only if the splitting plane is within the radius
+void CKdTree::search(int _node, const double* _x, double _sqrRadius,
+                     std::vector<int>& _indexes, std::vector<double>& _sqrDists) const
+{
+    const SNode& node = m_nodes[_node];
+
+    if (node.left < 0)
+    {
+        for (int k = node.first; k < node.last; ++k)
+        {
+            const double* y = gsl_matrix_const_ptr(m_X, m_perm[k], 0);
+
+            double sqrDist = 0.0;
+            for (size_t d = 0; d < m_X->size2 && sqrDist <= _sqrRadius; ++d)
+                sqrDist += (_x[d] - y[d]) * (_x[d] - y[d]);
+
+            if (sqrDist <= _sqrRadius)
+            {
+                _indexes.push_back(m_perm[k]);
+                _sqrDists.push_back(sqrDist);
+            }
+        }
+        return;
+    }
+
+    double diff = _x[node.dim] - node.split;
+    int    near = (diff <= 0) ? node.left  : node.right;
+    int    far  = (diff <= 0) ? node.right : node.left;
+
+    search(near, _x, _sqrRadius, _indexes, _sqrDists);
+
+    if (diff*diff <= _sqrRadius)
+        search(far, _x, _sqrRadius, _indexes, _sqrDists);
+}
@@ -0,0 +1,62 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+
+#ifndef KD_TREE_H
+#define KD_TREE_H
+
+#include <gsl/gsl_matrix.h>
+#include <vector>
+
+// k-d tree over the rows of a matrix (the matrix is not copied, it must outlive the tree).
+// Each node splits its points at the median of the dimension of largest spread; leaves hold
+// at most 'leafSize' points. Used to find the neighbors of a point within a radius without
+// computing its distance to all the points.
+class CKdTree
+{
+public:
+    // Constructor / Destructor (the cycle of life!)
+    CKdTree(const gsl_matrix* _X, int _leafSize = 16);
+    ~CKdTree()  { }
+
+    // Points (row indexes) within squared distance _sqrRadius of point x, and their squared
+    // distances (in no particular order; appended to the vectors)
+    void    radiusSearch(const double* _x, double _sqrRadius,
+                         std::vector<int>& _indexes, std::vector<double>& _sqrDists) const;
+
+private:
+    // Node of the tree: points m_perm[first..last), split on dimension 'dim' at value 'split'
+    // (left child: coordinates <= split, right child: coordinates >= split; -1 for a leaf)
+    struct SNode
+    {
+        int     first, last;
+        int     dim;
+        double  split;
+        int     left, right;
+    };
+
+    int     build(int _first, int _last);
+    void    search(int _node, const double* _x, double _sqrRadius,
+                   std::vector<int>& _indexes, std::vector<double>& _sqrDists) const;
+
+    const gsl_matrix*   m_X;
+    int                 m_leafSize;
+    std::vector<int>    m_perm;
+    std::vector<SNode>  m_nodes;
+};
+
+#endif // KD_TREE_H
@@ -17,6 +17,18 @@
 #include "Kernel.h"
 #include "Utils/MathUtils.h"
 #include <iostream>
+#include <algorithm>
+#include <numeric>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Number of examples per block (tile side) when the kernel matrix is computed with level-3 BLAS
+#define KERNEL_BLOCK_SIZE 256
+
+// Number of examples per block when the diagonal of a kernel matrix is computed
+#define KERNEL_DIAGONAL_BLOCK 64
 
 
 template <class T>
@@ -33,6 +45,7 @@ CKernel::CKernel()
     m_params[0] = 0.1;
     m_params[1] = 0.0;
     m_params[2] = 0.0;
+    m_nbThreads = 1;
 }
 
 // Constructor: Takes a costum function
@@ -42,6 +55,7 @@ CKernel::CKernel(KernelFct _fct, double _param1/*=1.0*/, double _param2/*=1.0*/,
     m_params[0] = _param1;
     m_params[1] = _param2;
     m_params[2] = _param3;
+    m_nbThreads = 1;
 }
 
 
@@ -52,6 +66,7 @@ CKernel::CKernel(const StrValueMap& _map)
     m_params[0] = 1.0;
     m_params[1] = 1.0;
     m_params[2] = 1.0;
+    m_nbThreads = 1;
 
     unserialize(_map);
 }
@@ -100,7 +115,11 @@ void CKernel::unserialize(const StrValueMap& _map)
     std::string name = "RBF";
     setParam(_map, "kernel", name, name);
 
-    if (name == "RBF")
+    if (name == "LINEAR")
+    {
+        m_kernelFct = LINEAR;
+    }
+    else if (name == "RBF")
     {
         m_kernelFct = RBF;
         setParam(_map, "kernel.gamma", m_params[0], 0.1);
@@ -120,37 +139,432 @@ void CKernel::unserialize(const StrValueMap& _map)
     }
 }
 
+// Set the number of threads used to compute kernel matrices (0 = one per processor)
+void CKernel::setNbThreads(int _nbThreads)
+{
+#ifdef _OPENMP
+    m_nbThreads = (_nbThreads > 0) ? _nbThreads : omp_get_num_procs();
+#else
+    m_nbThreads = 1;
+#endif
+}
+
 // Fill a (already allocated) matrix with kernel values
 //  - Rows correspond to examples from dataset X1
 //  - Columns correspond to examples from dataset X2
 //  => ie: K[i,j] = kernel( X1[i], X2[j] )
+// The work is split among 'm_nbThreads' threads (see setNbThreads)
 void CKernel::fillKernelMatrix(const CDataMatrix &_X1, const CDataMatrix &_X2, gsl_matrix* _K)
 {
-    if (_X1.nbFt != _X2.nbFt)
+    if ( !haveSameFeatures(_X1, _X2) )
         throw std::logic_error("[CKernel::fillKernelMatrix] Different number of features.");
 
     if (_K == NULL || (int)_K->size1 != _X1.nbEx || (int)_K->size2 != _X2.nbEx)
         throw std::logic_error("[CKernel::fillKernelMatrix] Kernel matrix incorrectly initialized.");
 
-    gsl_vector x1, x2;
+    // Built-in kernels are computed from the dot products X1*X2' (level-3 BLAS)
+    if (m_kernelFct == LINEAR || m_kernelFct == POLYNOMIAL || m_kernelFct == RBF || m_kernelFct == TANH)
+    {
+        fillKernelMatrixBlas(_X1, _X2, _K);
+        return;
+    }
+
+    // Custom kernel function: evaluate each pair of examples
+    // (only once per pair when both datasets are the same)
+    if ( _X1.isSparse() || _X2.isSparse() )
+        throw std::logic_error("[CKernel::fillKernelMatrix] Custom kernel functions need dense features.");
+
+    bool bSymmetric = isSameDataset(_X1, _X2);
+
+    #pragma omp parallel for schedule(dynamic) num_threads(m_nbThreads)
     for (int i = 0; i < _X1.nbEx; ++i)
     {
+        gsl_vector x1, x2;
         x1 = _X1.getRow(i);
 
-        for (int j = 0; j < _X2.nbEx; ++j)
+        for (int j = bSymmetric ? i : 0; j < _X2.nbEx; ++j)
         {
             x2 = _X2.getRow(j);
 
             gsl_matrix_set(_K, i, j, kernel(&x1,&x2));
+
+            if (bSymmetric)
+                gsl_matrix_set(_K, j, i, gsl_matrix_get(_K, i, j));
         }
     }
 }
 
 
+// View on consecutive examples of a dataset, as a dataset (the views on the features are
+// kept by the caller)
+static CDataMatrix viewExamples(const CDataMatrix &_X, int _i0, int _nbEx, gsl_matrix_view& _xView,
+                                CSparseMatrix& _sView, CTernaryMatrix& _tView)
+{
+    CDataMatrix examples;
+    examples.nbEx = _nbEx;
+    examples.nbFt = _X.nbFt;
+
+    if ( _X.isSparse() )
+    {
+        _sView = _X.S->rows(_i0, _nbEx);
+        examples.S = &_sView;
+    }
+    else
+    {
+        _xView = gsl_matrix_submatrix(_X.X, _i0, 0, _nbEx, _X.nbFt);
+        examples.X = &_xView.matrix;
+    }
+
+    if (_X.T != NULL)
+    {
+        _tView = _X.T->rows(_i0, _nbEx);
+        examples.T = &_tView;
+    }
+
+    return examples;
+}
+
+
+// Fill the kernel values between consecutive examples of a dataset and its first examples
+// (both seen as datasets, with views on the features of these examples)
+void CKernel::fillKernelRows(const CDataMatrix &_X, int _i0, int _nbRows, gsl_matrix* _K)
+{
+    gsl_matrix_view xRows, xCols;
+    CSparseMatrix   sRows, sCols;
+    CTernaryMatrix  tRows, tCols;
+
+    CDataMatrix rows = viewExamples(_X, _i0, _nbRows, xRows, sRows, tRows);
+
+    if ( (int)_K->size2 == _X.nbEx )
+        fillKernelMatrix(rows, _X, _K);
+    else
+        fillKernelMatrix(rows, viewExamples(_X, 0, _K->size2, xCols, sCols, tCols), _K);
+}
+
+
+// Fill the kernel values between the examples of a dataset and one of them
+void CKernel::fillKernelColumn(const CDataMatrix &_X, int _j, gsl_vector* _col)
+{
+    gsl_matrix_view xView;
+    CSparseMatrix   sView;
+    CTernaryMatrix  tView;
+
+    CDataMatrix example = viewExamples(_X, _j, 1, xView, sView, tView);
+
+    gsl_matrix_view K = gsl_matrix_view_array(_col->data, _X.nbEx, 1);  // _col of stride 1
+    fillKernelMatrix(_X, example, &K.matrix);
+}
+
+
+// Fill the diagonal of the kernel matrix of a dataset, from the kernel matrices of blocks of
+// consecutive examples
+void CKernel::fillKernelDiagonal(const CDataMatrix &_X, gsl_vector* _diag)
+{
+    gsl_matrix* K = gsl_matrix_alloc(KERNEL_DIAGONAL_BLOCK, KERNEL_DIAGONAL_BLOCK);
+
+    for (int i0 = 0; i0 < _X.nbEx; i0 += KERNEL_DIAGONAL_BLOCK)
+    {
+        int nb = std::min(KERNEL_DIAGONAL_BLOCK, _X.nbEx - i0);
+
+        gsl_matrix_view xView;
+        CSparseMatrix   sView;
+        CTernaryMatrix  tView;
+
+        CDataMatrix     block = viewExamples(_X, i0, nb, xView, sView, tView);
+        gsl_matrix_view Kb    = gsl_matrix_submatrix(K, 0, 0, nb, nb);
+        fillKernelMatrix(block, block, &Kb.matrix);
+
+        for (int k = 0; k < nb; ++k)
+            gsl_vector_set(_diag, i0+k, gsl_matrix_get(K, k, k));
+    }
+
+    gsl_matrix_free(K);
+}
+
+
+// Fill the kernel matrix of a built-in kernel function with the corresponding kernel functor
+void CKernel::fillKernelMatrixBlas(const CDataMatrix &_X1, const CDataMatrix &_X2, gsl_matrix* _K)
+{
+    if (m_kernelFct == LINEAR)
+    {
+        fillTiles(_X1, _X2, _K, LinearOp());
+    }
+    else if (m_kernelFct == RBF)
+    {
+        fillTiles(_X1, _X2, _K, RbfOp(m_params[0]));
+    }
+    else if (m_kernelFct == TANH)
+    {
+        fillTiles(_X1, _X2, _K, TanhOp(m_params[0], m_params[1]));
+    }
+    else if (m_kernelFct == POLYNOMIAL)
+    {
+        // Small integer degrees are expanded at compile time (instead of calling 'pow')
+        double d = m_params[0];
+        double s = m_params[1];
+        double c = m_params[2];
+
+        int degree = (d == floor(d) && d >= 1 && d <= 6) ? (int)d : 0;
+        switch (degree)
+        {
+            case 1:  fillTiles(_X1, _X2, _K, PolyOp<1>(s, c));   break;
+            case 2:  fillTiles(_X1, _X2, _K, PolyOp<2>(s, c));   break;
+            case 3:  fillTiles(_X1, _X2, _K, PolyOp<3>(s, c));   break;
+            case 4:  fillTiles(_X1, _X2, _K, PolyOp<4>(s, c));   break;
+            case 5:  fillTiles(_X1, _X2, _K, PolyOp<5>(s, c));   break;
+            case 6:  fillTiles(_X1, _X2, _K, PolyOp<6>(s, c));   break;
+            default: fillTiles(_X1, _X2, _K, PolyRealOp(d, s, c));
+        }
+    }
+}
+
+
+// Fill a (already allocated) matrix with squared distances: D[i,j] = ||X1[i] - X2[j]||^2
+void CKernel::fillSqrDistMatrix(const CDataMatrix &_X1, const CDataMatrix &_X2, gsl_matrix* _D)
+{
+    if ( !haveSameFeatures(_X1, _X2) )
+        throw std::logic_error("[CKernel::fillSqrDistMatrix] Different number of features.");
+
+    if (_D == NULL || (int)_D->size1 != _X1.nbEx || (int)_D->size2 != _X2.nbEx)
+        throw std::logic_error("[CKernel::fillSqrDistMatrix] Distance matrix incorrectly initialized.");
+
+    fillTiles(_X1, _X2, _D, SqrDistOp());
+}
+
+
+// Fill a (already allocated) matrix with RBF kernel values computed from squared distances
+// (given by 'fillSqrDistMatrix'): K[i,j] = exp(-gamma D[i,j]). K and D may be the same matrix.
+void CKernel::fillRbfFromSqrDist(const gsl_matrix* _D, gsl_matrix* _K)
+{
+    if (m_kernelFct != RBF)
+        throw std::logic_error("[CKernel::fillRbfFromSqrDist] Not a RBF kernel.");
+
+    if (_D == NULL || _K == NULL || _K->size1 != _D->size1 || _K->size2 != _D->size2)
+        throw std::logic_error("[CKernel::fillRbfFromSqrDist] Kernel matrix incorrectly initialized.");
+
+    double gamma = m_params[0];
+
+    #pragma omp parallel for schedule(static) num_threads(m_nbThreads)
+    for (int i = 0; i < (int)_K->size1; ++i)
+    {
+        const double* dist = gsl_matrix_const_ptr(_D, i, 0);
+        double*       row  = gsl_matrix_ptr(_K, i, 0);
+
+        for (size_t j = 0; j < _K->size2; ++j)
+            row[j] = -1 * gamma * dist[j];
+
+        VectorMath::exp(row, _K->size2);
+    }
+}
+
+
+// Fill the kernel matrix one tile at the time:
+//  - the dot products of a tile are computed at once with dgemm
+//  - the tile is then transformed in place into kernel values by the functor '_op'
+template <class Op>
+void CKernel::fillTiles(const CDataMatrix &_X1, const CDataMatrix &_X2, gsl_matrix* _K, const Op& _op)
+{
+    // Squared norms of the examples (if needed by the functor: ||x-y||^2 = x*x + y*y - 2 x*y)
+    gsl_vector* vSqrNorms1 = NULL;
+    gsl_vector* vSqrNorms2 = NULL;
+
+    if (Op::bNeedSqrNorms)
+    {
+        vSqrNorms1 = allocSqrNorms(_X1);
+        vSqrNorms2 = allocSqrNorms(_X2);
+    }
+
+    // Sparse features: dot products over the nonzero values only
+    if ( _X1.isSparse() || _X2.isSparse() )
+    {
+        fillSparseRows(_X1, _X2, _K, _op, vSqrNorms1, vSqrNorms2);
+
+        if (vSqrNorms1 != NULL) gsl_vector_free(vSqrNorms1);
+        if (vSqrNorms2 != NULL) gsl_vector_free(vSqrNorms2);
+        return;
+    }
+
+    // The kernel matrix is split in tiles, which are shared among the threads
+    int nbTileRows = (_X1.nbEx + KERNEL_BLOCK_SIZE - 1) / KERNEL_BLOCK_SIZE;
+    int nbTileCols = (_X2.nbEx + KERNEL_BLOCK_SIZE - 1) / KERNEL_BLOCK_SIZE;
+
+    // When both datasets are the same, only the upper tiles are computed
+    // and each one is mirrored in the lower part of the matrix
+    bool bSymmetric = isSameDataset(_X1, _X2);
+
+    // Ternary features of both datasets: the dot products are computed from the bit-packed examples
+    bool bPacked = _X1.T != NULL && _X2.T != NULL && _X1.nbFt == _X2.nbFt;
+
+    #pragma omp parallel for schedule(dynamic) num_threads(m_nbThreads)
+    for (int t = 0; t < nbTileRows*nbTileCols; ++t)
+    {
+        if (bSymmetric && t % nbTileCols < t / nbTileCols)
+            continue;
+
+        int i0 = (t / nbTileCols) * KERNEL_BLOCK_SIZE;
+        int j0 = (t % nbTileCols) * KERNEL_BLOCK_SIZE;
+
+        int nbRows = std::min(KERNEL_BLOCK_SIZE, _X1.nbEx - i0);
+        int nbCols = std::min(KERNEL_BLOCK_SIZE, _X2.nbEx - j0);
+
+        gsl_matrix_view Kblock  = gsl_matrix_submatrix(_K, i0, j0, nbRows, nbCols);
+
+        if (bPacked)
+        {
+            packedProduct(&Kblock.matrix, *_X1.T, i0, *_X2.T, j0);
+        }
+        else
+        {
+            gsl_matrix_view X1block = gsl_matrix_submatrix(_X1.X, i0, 0, nbRows, _X1.nbFt);
+            gsl_matrix_view X2block = gsl_matrix_submatrix(_X2.X, j0, 0, nbCols, _X2.nbFt);
+
+            MathUtils::matrixProduct(&Kblock.matrix, &X1block.matrix, &X2block.matrix, false, true);
+        }
+
+        transformBlock(&Kblock.matrix, _op,
+                       Op::bNeedSqrNorms ? vSqrNorms1->data + i0 : NULL,
+                       Op::bNeedSqrNorms ? vSqrNorms2->data + j0 : NULL );
+
+        if (bSymmetric)
+            mirrorBlock(_K, i0, j0, nbRows, nbCols);
+    }
+
+    if (vSqrNorms1 != NULL) gsl_vector_free(vSqrNorms1);
+    if (vSqrNorms2 != NULL) gsl_vector_free(vSqrNorms2);
+}
+
+
+// Fill the kernel matrix one row at the time, when at least one dataset has sparse features.
+// Each example x1 of X1 is scattered into a dense vector, then its dot product with each example
+// x2 of X2 costs O(nonzeros of x2) (or O(nonzeros of x1) if X2 is dense). The row is then
+// transformed in place by the functor '_op'. When both datasets are the same, only the upper
+// part of each row is computed, then mirrored.
+template <class Op>
+void CKernel::fillSparseRows(const CDataMatrix &_X1, const CDataMatrix &_X2, gsl_matrix* _K, const Op& _op,
+                             gsl_vector* _vSqrNorms1, gsl_vector* _vSqrNorms2)
+{
+    bool bSymmetric = isSameDataset(_X1, _X2);
+    int  nbFt       = std::max(_X1.nbFt, _X2.nbFt);
+
+    #pragma omp parallel num_threads(m_nbThreads)
+    {
+        std::vector<double> x1(nbFt, 0.0);
+
+        #pragma omp for schedule(dynamic)
+        for (int i = 0; i < _X1.nbEx; ++i)
+        {
+            int     j0  = bSymmetric ? i : 0;
+            double* row = gsl_matrix_ptr(_K, i, 0);
+
+            if ( _X2.isSparse() || _X1.nbFt > _X2.nbFt )
+            {
+                if ( _X1.isSparse() )
+                    _X1.S->scatter(i, &x1[0]);
+                else
+                    std::copy(gsl_matrix_ptr(_X1.X, i, 0), gsl_matrix_ptr(_X1.X, i, 0) + _X1.nbFt, x1.begin());
+
+                for (int j = j0; j < _X2.nbEx; ++j)
+                {
+                    if ( _X2.isSparse() )
+                        row[j] = _X2.S->dot(j, &x1[0]);
+                    else
+                        row[j] = std::inner_product(x1.begin(), x1.begin() + _X2.nbFt, gsl_matrix_ptr(_X2.X, j, 0), 0.0);
+                }
+
+                if ( _X1.isSparse() )
+                    _X1.S->clear(i, &x1[0]);
+            }
+            else
+            {
+                for (int j = j0; j < _X2.nbEx; ++j)
+                    row[j] = _X1.S->dot(i, gsl_matrix_ptr(_X2.X, j, 0));
+            }
+
+            _op.transformRow(row + j0, _X2.nbEx - j0,
+                             Op::bNeedSqrNorms ? gsl_vector_get(_vSqrNorms1, i) : 0.0,
+                             Op::bNeedSqrNorms ? _vSqrNorms2->data + j0 : NULL );
+
+            if (bSymmetric)
+            {
+                for (int j = i+1; j < _X2.nbEx; ++j)
+                    gsl_matrix_set(_K, j, i, row[j]);
+            }
+        }
+    }
+}
+
+
+// Fill a block with the dot products of bit-packed examples: K[i,j] = X1[i0+i] * X2[j0+j]
+void CKernel::packedProduct(gsl_matrix* _K, const CTernaryMatrix& _X1, int _i0, const CTernaryMatrix& _X2, int _j0)
+{
+    for (size_t i = 0; i < _K->size1; ++i)
+    {
+        double* row = gsl_matrix_ptr(_K, i, 0);
+
+        for (size_t j = 0; j < _K->size2; ++j)
+            row[j] = _X1.dot(_i0 + i, _X2, _j0 + j);
+    }
+}
+
+
+// Transform a block of dot products into kernel values with the functor '_op'
+// _sqrNorms1, _sqrNorms2 : squared norms of the block rows / columns examples (NULL if not needed)
+template <class Op>
+void CKernel::transformBlock(gsl_matrix* _K, const Op& _op, const double* _sqrNorms1, const double* _sqrNorms2)
+{
+    for (size_t i = 0; i < _K->size1; ++i)
+    {
+        double* row = gsl_matrix_ptr(_K, i, 0);
+
+        _op.transformRow(row, _K->size2, Op::bNeedSqrNorms ? _sqrNorms1[i] : 0.0, _sqrNorms2);
+    }
+}
+
+
+// Copy the block K[i0..i0+nbRows, j0..j0+nbCols] at its symmetric position.
+// For a block on the diagonal, its upper part is copied into its lower part.
+void CKernel::mirrorBlock(gsl_matrix* _K, int _i0, int _j0, int _nbRows, int _nbCols)
+{
+    for (int i = 0; i < _nbRows; ++i)
+    {
+        for (int j = (_i0 == _j0) ? i+1 : 0; j < _nbCols; ++j)
+            gsl_matrix_set(_K, _j0+j, _i0+i, gsl_matrix_get(_K, _i0+i, _j0+j));
+    }
+}
+
+
+// Allocate a vector containing the squared norm of each example of a dataset
+gsl_vector* CKernel::allocSqrNorms(const CDataMatrix &_X)
+{
+    gsl_vector* vSqrNorms = gsl_vector_alloc(_X.nbEx);
+
+    gsl_vector x;
+    for (int i = 0; i < _X.nbEx; ++i)
+    {
+        if ( _X.isSparse() )
+        {
+            gsl_vector_set(vSqrNorms, i, _X.S->sqrNorm(i));
+            continue;
+        }
+
+        if (_X.T != NULL)
+        {
+            gsl_vector_set(vSqrNorms, i, _X.T->sqrNorm(i));
+            continue;
+        }
+
+        x = _X.getRow(i);
+        gsl_vector_set(vSqrNorms, i, MathUtils::dot(&x, &x));
+    }
+
+    return vSqrNorms;
+}
+
+
 // Allocate memory for a new matrix and compute kernel values with 'fillKernelMatrix' function defined above.
 CDataMatrix CKernel::createKernelMatrix(const CDataMatrix &_X1, const CDataMatrix &_X2)
 {
-    if (_X1.nbFt != _X2.nbFt)
+    if ( !haveSameFeatures(_X1, _X2) )
         throw std::logic_error("[CKernel::createKernelMatrix] Different number of features.");
 
     CDataMatrix K;
@@ -167,9 +581,9 @@ CDataMatrix CKernel::createKernelMatrix(const CDataMatrix &_X1, const CDataMatri
 // LINEAR KERNEL
 // Function:    k(x,y) = x*y
 // Parameters:  none
-double CKernel::LINEAR(gsl_vector* _x1, gsl_vector* _x2, double *_params)
+double CKernel::LINEAR(gsl_vector* _x1, gsl_vector* _x2, double* /*_params*/)
 {
-    return MathUtils::dot(_x1, _x2);
+    return LinearOp()( MathUtils::dot(_x1, _x2), 0.0, 0.0 );
 }
 
 // POLYNOMIAL KERNEL
@@ -179,7 +593,7 @@ double CKernel::LINEAR(gsl_vector* _x1, gsl_vector* _x2, double *_params)
 //              c = _params[2]
 double CKernel::POLYNOMIAL(gsl_vector* _x1, gsl_vector* _x2, double *_params)
 {
-    return pow( ( _params[1] * MathUtils::dot(_x1, _x2) + _params[2] ) , _params[0] );
+    return PolyRealOp(_params[0], _params[1], _params[2])( MathUtils::dot(_x1, _x2), 0.0, 0.0 );
 }
 
 // GAUSSIAN KERNEL
@@ -187,14 +601,15 @@ double CKernel::POLYNOMIAL(gsl_vector* _x1, gsl_vector* _x2, double *_params)
 // Parameters:  gamma = _params[0]
 double CKernel::RBF(gsl_vector* _x1, gsl_vector* _x2, double *_params)
 {
-    return exp( -1 * _params[0] * MathUtils::sqrDistance(_x1,_x2) );
+    return RbfOp(_params[0])( MathUtils::dot(_x1, _x2), MathUtils::dot(_x1, _x1), MathUtils::dot(_x2, _x2) );
 }
 
 // SIGMOID KERNEL
+// Function:    k(x,y) = tanh(s x*y + c)
 // Parameters:  s = _params[0]
 //              c = _params[1]
 double CKernel::TANH(gsl_vector* _x1, gsl_vector* _x2, double *_params)
 {
-    return tanh( _params[0] * MathUtils::dot(_x1, _x2) + _params[1] );
+    return TanhOp(_params[0], _params[1])( MathUtils::dot(_x1, _x2), 0.0, 0.0 );
 }
 
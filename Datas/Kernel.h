@@ -19,8 +19,10 @@
 
 #include "DataMatrix.h"
 #include "Utils/StrValue.h"
+#include "Utils/VectorMath.h"
 
 #include <gsl/gsl_vector.h>
+#include <cmath>
 
 class CKernel
 {
@@ -38,6 +40,10 @@ public:
     StrValueMap serialize();
     void        unserialize(const StrValueMap& _map);
 
+    // Number of threads used to compute kernel matrices (0 = one per processor)
+    void        setNbThreads(int _nbThreads);
+    int         getNbThreads() const    { return m_nbThreads; }
+
     // Compute kernel function between two vector-examples
     double kernel(gsl_vector* _x1, gsl_vector* _x2);
 
@@ -45,6 +51,21 @@ public:
     CDataMatrix createKernelMatrix(const CDataMatrix& _X1, const CDataMatrix& _X2);
     void        fillKernelMatrix(const CDataMatrix& _X1, const CDataMatrix& _X2, gsl_matrix* _K);
 
+    // Fill the kernel values between the examples [_i0, _i0+_nbRows) of a dataset and its first
+    // examples: _K is [_nbRows]x[nb first examples] (all of them to get whole rows). The kernel
+    // matrix being symmetric, whole rows are also its columns [_i0, _i0+_nbRows).
+    void        fillKernelRows(const CDataMatrix& _X, int _i0, int _nbRows, gsl_matrix* _K);
+
+    // Fill the kernel values between the examples of a dataset and its example _j (column _j of
+    // its kernel matrix), or the diagonal of its kernel matrix: k(x_i,x_i)
+    void        fillKernelColumn(const CDataMatrix& _X, int _j, gsl_vector* _col);
+    void        fillKernelDiagonal(const CDataMatrix& _X, gsl_vector* _diag);
+
+    // Compute the squared distances ||x1-x2||^2 between two matrix-datasets, then derive the
+    // RBF kernel matrix from them (several gamma values can be tried without recomputing distances)
+    void        fillSqrDistMatrix(const CDataMatrix& _X1, const CDataMatrix& _X2, gsl_matrix* _D);
+    void        fillRbfFromSqrDist(const gsl_matrix* _D, gsl_matrix* _K);
+
     // Already implemented Kernel Funnctions
     static double LINEAR        (gsl_vector* _x1, gsl_vector* _x2, double* _params);
     static double POLYNOMIAL    (gsl_vector* _x1, gsl_vector* _x2, double* _params);
@@ -52,11 +73,39 @@ public:
     static double TANH          (gsl_vector* _x1, gsl_vector* _x2, double* _params);
 
 private:
+    // Compute the kernel matrix of a built-in kernel from blocks of dot products (level-3 BLAS)
+    void        fillKernelMatrixBlas(const CDataMatrix& _X1, const CDataMatrix& _X2, gsl_matrix* _K);
+
+    template <class Op>
+    void        fillTiles(const CDataMatrix& _X1, const CDataMatrix& _X2, gsl_matrix* _K, const Op& _op);
+
+    template <class Op>
+    void        fillSparseRows(const CDataMatrix& _X1, const CDataMatrix& _X2, gsl_matrix* _K, const Op& _op,
+                               gsl_vector* _vSqrNorms1, gsl_vector* _vSqrNorms2);
+
+    template <class Op>
+    static void transformBlock(gsl_matrix* _K, const Op& _op, const double* _sqrNorms1, const double* _sqrNorms2);
+
+    static void        packedProduct(gsl_matrix* _K, const CTernaryMatrix& _X1, int _i0,
+                                     const CTernaryMatrix& _X2, int _j0);
+    static void        mirrorBlock(gsl_matrix* _K, int _i0, int _j0, int _nbRows, int _nbCols);
+    static gsl_vector* allocSqrNorms(const CDataMatrix& _X);
+
+    // True if both datasets share the same features matrix (then the kernel matrix is symmetric)
+    static bool        isSameDataset(const CDataMatrix& _X1, const CDataMatrix& _X2);
+
+    // True if the examples of both datasets can be compared (sparse examples may have fewer
+    // features than the others: missing ones are null)
+    static bool        haveSameFeatures(const CDataMatrix& _X1, const CDataMatrix& _X2);
+
     // Pointer to kernel function
     KernelFct   m_kernelFct;
 
     // Kernel parameter values
     double      m_params[3];
+
+    // Number of threads used to compute kernel matrices
+    int         m_nbThreads;
 };
 
 
@@ -66,4 +115,119 @@ inline double CKernel::kernel(gsl_vector* _x1, gsl_vector* _x2)
     return m_kernelFct(_x1, _x2, m_params);
 }
 
+inline bool CKernel::isSameDataset(const CDataMatrix& _X1, const CDataMatrix& _X2)
+{
+    return _X1.X == _X2.X && _X1.S == _X2.S && _X1.nbEx == _X2.nbEx;
+}
+
+inline bool CKernel::haveSameFeatures(const CDataMatrix& _X1, const CDataMatrix& _X2)
+{
+    return _X1.nbFt == _X2.nbFt || _X1.isSparse() || _X2.isSparse();
+}
+
+
+// Kernel functors: compute a built-in kernel value from the dot product x*y
+// and from the squared norms x*x and y*y (only provided if 'bNeedSqrNorms' is true).
+// They are instantiated in the kernel matrix computation loop, where they can be inlined.
+//  - operator() computes a single kernel value
+//  - transformRow() transforms in place a whole row of dot products into kernel values
+//    (RBF and TANH use the batch exp / tanh functions of VectorMath)
+
+struct LinearOp
+{
+    static const bool bNeedSqrNorms = false;
+
+    double operator()(double _dot, double, double) const { return _dot; }
+    void   transformRow(double*, int, double, const double*) const { }
+};
+
+struct RbfOp
+{
+    static const bool bNeedSqrNorms = true;
+    double gamma;
+
+    RbfOp(double _gamma) : gamma(_gamma) { }
+    double operator()(double _dot, double _sqrNorm1, double _sqrNorm2) const
+        { return exp( -1 * gamma * (_sqrNorm1 + _sqrNorm2 - 2*_dot) ); }
+
+    void   transformRow(double* _row, int _n, double _sqrNorm1, const double* _sqrNorms2) const
+    {
+        for (int j = 0; j < _n; ++j)
+            _row[j] = -1 * gamma * (_sqrNorm1 + _sqrNorms2[j] - 2*_row[j]);
+
+        VectorMath::exp(_row, _n);
+    }
+};
+
+struct SqrDistOp
+{
+    static const bool bNeedSqrNorms = true;
+
+    double operator()(double _dot, double _sqrNorm1, double _sqrNorm2) const
+        { return _sqrNorm1 + _sqrNorm2 - 2*_dot; }
+
+    void   transformRow(double* _row, int _n, double _sqrNorm1, const double* _sqrNorms2) const
+    {
+        for (int j = 0; j < _n; ++j)
+            _row[j] = _sqrNorm1 + _sqrNorms2[j] - 2*_row[j];
+    }
+};
+
+struct TanhOp
+{
+    static const bool bNeedSqrNorms = false;
+    double s, c;
+
+    TanhOp(double _s, double _c) : s(_s), c(_c) { }
+    double operator()(double _dot, double, double) const { return tanh( s * _dot + c ); }
+
+    void   transformRow(double* _row, int _n, double, const double*) const
+    {
+        for (int j = 0; j < _n; ++j)
+            _row[j] = s * _row[j] + c;
+
+        VectorMath::tanh(_row, _n);
+    }
+};
+
+// Polynomial kernel of any (real) degree
+struct PolyRealOp
+{
+    static const bool bNeedSqrNorms = false;
+    double d, s, c;
+
+    PolyRealOp(double _d, double _s, double _c) : d(_d), s(_s), c(_c) { }
+    double operator()(double _dot, double, double) const { return pow( s * _dot + c, d ); }
+
+    void   transformRow(double* _row, int _n, double, const double*) const
+    {
+        for (int j = 0; j < _n; ++j)
+            _row[j] = (*this)(_row[j], 0.0, 0.0);
+    }
+};
+
+// Polynomial kernel of integer degree D (the power is expanded into multiplications)
+template <int D>
+inline double intPower(double _x)    { return intPower<D/2>(_x*_x) * ( (D%2) ? _x : 1.0 ); }
+
+template <>
+inline double intPower<0>(double)    { return 1.0; }
+
+template <int D>
+struct PolyOp
+{
+    static const bool bNeedSqrNorms = false;
+    double s, c;
+
+    PolyOp(double _s, double _c) : s(_s), c(_c) { }
+    double operator()(double _dot, double, double) const { return intPower<D>( s * _dot + c ); }
+
+    void   transformRow(double* _row, int _n, double, const double*) const
+    {
+        for (int j = 0; j < _n; ++j)
+            _row[j] = (*this)(_row[j], 0.0, 0.0);
+    }
+};
+
+
 # endif // KERNEL_H
@@ -0,0 +1,175 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+#include "KernelFeatures.h"
+
+#include <stdexcept>
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+
+
+// Constructor
+CKernelFeatures::CKernelFeatures(CKernel _kernel)
+: CFeatureMap()
+{
+    m_kernel   = _kernel;
+    m_nbInputs = -1;
+
+    getParameters(_kernel, m_degree, m_s, m_c);
+}
+
+
+// True if the kernel has exact features
+bool CKernelFeatures::isSupported(CKernel _kernel)
+{
+    int    degree;
+    double s, c;
+
+    return getParameters(_kernel, degree, s, c);
+}
+
+
+// Degree and parameters of the kernel: LINEAR is (x*y)^1
+bool CKernelFeatures::getParameters(CKernel _kernel, int& _degree, double& _s, double& _c)
+{
+    StrValueMap kMap = _kernel.serialize();
+    string      name = kMap["kernel"];
+
+    _degree = 1;
+    _s      = 1.0;
+    _c      = 0.0;
+
+    if (name == "LINEAR")
+        return true;
+
+    if (name != "POLY")
+        return false;
+
+    double d = kMap["kernel.d"];
+    _degree  = max(1, (int)d);
+    _s       = kMap["kernel.s"];
+    _c       = kMap["kernel.c"];
+
+    return d == (int)d && d >= 1 && _s > 0.0 && _c >= 0.0;
+}
+
+
+// Save the features parameters (with the kernel ones)
+StrValueMap CKernelFeatures::serialize()
+{
+    StrValueMap map = m_kernel.serialize();
+
+    map["factored"] = true;
+
+    return map;
+}
+
+
+// Number of features: C(v+p-1, p)
+int CKernelFeatures::getNbFeatures(int _nbInputs)
+{
+    if (_nbInputs != m_nbInputs)
+        enumerate(_nbInputs);
+
+    return m_coefs.size();
+}
+
+
+// Enumerate the monomials x'_i1 * ... * x'_ip with i1 <= ... <= ip, and their coefficient
+// sqrt( p! / (a_1! ... a_v!) ), where a_k counts the occurences of variable k
+void CKernelFeatures::enumerate(int _nbInputs)
+{
+    int nbVars = _nbInputs + (m_c > 0.0 ? 1 : 0);
+
+    m_nbInputs = _nbInputs;
+    m_indices.clear();
+    m_coefs.clear();
+
+    vector<int> monomial(m_degree, 0);
+
+    while (true)
+    {
+        // Coefficient: p! / product of (runs length)!
+        double coef = 1.0;
+        for (int k = 2; k <= m_degree; ++k)
+            coef *= k;
+
+        int run = 1;
+        for (int k = 1; k <= m_degree; ++k)
+        {
+            if (k < m_degree && monomial[k] == monomial[k-1])
+                ++run;
+            else
+            {
+                for (int r = 2; r <= run; ++r)
+                    coef /= r;
+                run = 1;
+            }
+        }
+
+        m_indices.insert(m_indices.end(), monomial.begin(), monomial.end());
+        m_coefs.push_back( sqrt(coef) );
+
+        // Next non decreasing sequence of indices
+        int k = m_degree-1;
+        while (k >= 0 && monomial[k] == nbVars-1)
+            --k;
+
+        if (k < 0)
+            break;
+
+        ++monomial[k];
+        for (int j = k+1; j < m_degree; ++j)
+            monomial[j] = monomial[k];
+    }
+}
+
+
+// Fill the features of each example
+void CKernelFeatures::fill(const CDataMatrix& _X, gsl_matrix* _Z)
+{
+    if (_X.nbFt != m_nbInputs)
+        enumerate(_X.nbFt);
+
+    int nbFeatures = m_coefs.size();
+    double sqrtS   = sqrt(m_s);
+    double sqrtC   = sqrt(m_c);
+
+    vector<double> vars(_X.nbFt + 1);
+
+    for (int i = 0; i < _X.nbEx; ++i)
+    {
+        // x' = (sqrt(s) x, sqrt(c))
+        for (int j = 0; j < _X.nbFt; ++j)
+            vars[j] = sqrtS * gsl_matrix_get(_X.X, i, j);
+        vars[_X.nbFt] = sqrtC;
+
+        double*    row     = gsl_matrix_ptr(_Z, i, 0);
+        const int* indices = &m_indices[0];
+
+        for (int f = 0; f < nbFeatures; ++f, indices += m_degree)
+        {
+            double value = m_coefs[f];
+            for (int k = 0; k < m_degree; ++k)
+                value *= vars[ indices[k] ];
+
+            row[f] = value;
+        }
+    }
+}
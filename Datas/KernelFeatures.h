@@ -0,0 +1,68 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+#ifndef KERNEL_FEATURES_H
+#define KERNEL_FEATURES_H
+
+#include "FeatureMap.h"
+
+#include <vector>
+
+// Exact features of the LINEAR kernel (z(x) = x) and of the POLY kernel of integer degree p,
+// with s > 0 and c >= 0. Writing x' = (sqrt(s) x, sqrt(c)), the multinomial expansion of
+//      (s x*y + c)^p = (x'*y')^p
+// gives one feature by monomial of degree p of x':  z_a(x) = sqrt( p! / (a_1! ... a_v!) ) * x'^a
+// There are C(v+p-1, p) such features (v = d+1, or v = d if c = 0): the factored mode is
+// worth it for small input dimensions d and degrees p only.
+class CKernelFeatures : public CFeatureMap
+{
+public:
+    // Constructor / Destructor (the cycle of life!)
+    // The kernel must have exact features (see isSupported)
+    CKernelFeatures(CKernel _kernel);
+    virtual ~CKernelFeatures()  { }
+
+    // True if the kernel has exact features: LINEAR, or POLY with an integer degree d >= 1,
+    // s > 0 and c >= 0
+    static bool         isSupported(CKernel _kernel);
+
+    virtual StrValueMap serialize();
+
+    virtual std::string getName()   { return "exact kernel features"; }
+    virtual int         getNbFeatures(int _nbInputs);
+
+protected:
+    virtual void        fill(const CDataMatrix& _X, gsl_matrix* _Z);
+
+private:
+    // Degree and parameters of the kernel, seen as (s x*y + c)^p (false if it has no exact features)
+    static bool         getParameters(CKernel _kernel, int& _degree, double& _s, double& _c);
+
+    // Enumerate the monomials of degree p of v variables (non decreasing variables indices)
+    void                enumerate(int _nbInputs);
+
+    CKernel             m_kernel;
+    int                 m_degree;
+    double              m_s, m_c;
+
+    // Monomials: 'm_degree' variables indices and a coefficient for each of them
+    int                 m_nbInputs;
+    std::vector<int>    m_indices;
+    std::vector<double> m_coefs;
+};
+
+#endif // KERNEL_FEATURES_H
@@ -0,0 +1,267 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+#include "KernelMatrix.h"
+#include "Utils/MathUtils.h"
+
+#include <algorithm>
+
+// Number of columns read ahead by 'readAhead'
+#define KERNEL_READAHEAD 4
+
+
+// Constructor
+CKernelMatrix::CKernelMatrix()
+{
+    Y    = NULL;
+    W    = NULL;
+    nbEx = 0;
+    nbFt = 0;
+}
+
+
+// Dot product between a column and a vector
+double CKernelMatrix::colDot(int _j, gsl_vector* _v)
+{
+    gsl_vector col = getCol(_j);
+    return (W != NULL) ? MathUtils::dot(&col, _v, W) : MathUtils::dot(&col, _v);
+}
+
+
+// Add a multiple of a column to a vector
+void CKernelMatrix::colAxpy(int _j, double _factor, gsl_vector* _v)
+{
+    gsl_vector col = getCol(_j);
+    MathUtils::add(_v, &col, _factor);
+}
+
+
+// Sum of the squared elements of a column
+double CKernelMatrix::colSqrNorm(int _j)
+{
+    gsl_vector col = getCol(_j);
+    return (W != NULL) ? MathUtils::dot(&col, &col, W) : MathUtils::dot(&col, &col);
+}
+
+
+// Dot product between two columns (both remain valid, see getCol)
+double CKernelMatrix::colColDot(int _i, int _j)
+{
+    gsl_vector col1 = getCol(_i);
+    gsl_vector col2 = getCol(_j);
+    return (W != NULL) ? MathUtils::dot(&col1, &col2, W) : MathUtils::dot(&col1, &col2);
+}
+
+
+// Matrix by vector product, one column at the time (columns of null weight are skipped)
+void CKernelMatrix::mvProduct(gsl_vector* _ptrVector, gsl_vector* _w)
+{
+    gsl_vector_set_all(_ptrVector, 0.0);
+
+    for (int j = 0; j < nbFt; ++j)
+    {
+        double w_j = gsl_vector_get(_w, j);
+        if (w_j != 0.0)
+            colAxpy(j, w_j, _ptrVector);
+    }
+}
+
+
+// Announce the columns visited after position _pos of a visit order: all the first ones when
+// the visit starts, then one more at each position
+void CKernelMatrix::readAhead(const std::vector<int>& _order, int _pos)
+{
+    int first = (_pos == 0) ? 0 : _pos + KERNEL_READAHEAD;
+    int last  = std::min(_pos + KERNEL_READAHEAD, (int)_order.size() - 1);
+
+    for (int k = first; k <= last; ++k)
+        prefetchCol( _order[k] % nbFt );
+}
+
+
+// Constructor
+CImplicitBiasKernelMatrix::CImplicitBiasKernelMatrix()
+: CKernelMatrix()
+{
+    m_vBias = NULL;
+}
+
+
+// Set the size of the matrix and create the bias column
+void CImplicitBiasKernelMatrix::setSize(int _nbEx)
+{
+    nbEx = _nbEx;
+    nbFt = _nbEx+1;
+
+    m_vBias = gsl_vector_alloc(nbEx);
+    gsl_vector_set_all(m_vBias, 1.0);
+}
+
+
+// Desallocate memory
+void CImplicitBiasKernelMatrix::free()
+{
+    if (m_vBias != NULL) gsl_vector_free(m_vBias);
+    m_vBias = NULL;
+}
+
+
+// Get a whole matrix column
+gsl_vector CImplicitBiasKernelMatrix::getCol(int _j)
+{
+    if (_j == nbEx)
+        return gsl_vector_subvector(m_vBias, 0, nbEx).vector;
+
+    return getKernelCol(_j);
+}
+
+
+// Dot product between a column and a vector
+double CImplicitBiasKernelMatrix::colDot(int _j, gsl_vector* _v)
+{
+    if (W != NULL)
+        return CKernelMatrix::colDot(_j, _v);  // weighted rows
+
+    if (_j == nbEx)
+    {
+        gsl_vector v = gsl_vector_subvector(_v, 0, nbEx).vector;
+        return MathUtils::sum(&v);
+    }
+
+    return kernelColDot(_j, _v);
+}
+
+
+// Add a multiple of a column to a vector (the rows weights do not apply)
+void CImplicitBiasKernelMatrix::colAxpy(int _j, double _factor, gsl_vector* _v)
+{
+    if (_j == nbEx)
+        gsl_vector_add_constant(_v, _factor);
+    else
+        kernelColAxpy(_j, _factor, _v);
+}
+
+
+// Sum of the squared elements of a column
+double CImplicitBiasKernelMatrix::colSqrNorm(int _j)
+{
+    if (W != NULL)
+        return CKernelMatrix::colSqrNorm(_j);  // weighted rows
+
+    return (_j == nbEx) ? nbEx : kernelColColDot(_j, _j);
+}
+
+
+// Dot product between two columns
+double CImplicitBiasKernelMatrix::colColDot(int _i, int _j)
+{
+    if (W != NULL)
+        return CKernelMatrix::colColDot(_i, _j);  // weighted rows
+
+    if (_i == nbEx && _j == nbEx)
+        return nbEx;
+
+    if (_i == nbEx || _j == nbEx)
+        return kernelColSum( (_i == nbEx) ? _j : _i );
+
+    return kernelColColDot(_i, _j);
+}
+
+
+// Matrix by vector product: the bias part, then the kernel columns
+void CImplicitBiasKernelMatrix::mvProduct(gsl_vector* _ptrVector, gsl_vector* _w)
+{
+    gsl_vector_set_all(_ptrVector, gsl_vector_get(_w, nbEx));
+    kernelMvProduct(_ptrVector, _w);
+}
+
+
+// Dot product between a kernel column and a vector
+double CImplicitBiasKernelMatrix::kernelColDot(int _j, gsl_vector* _v)
+{
+    gsl_vector col = getKernelCol(_j);
+    gsl_vector v   = gsl_vector_subvector(_v, 0, nbEx).vector;
+    return MathUtils::dot(&col, &v);
+}
+
+
+// Add a multiple of a kernel column to a vector
+void CImplicitBiasKernelMatrix::kernelColAxpy(int _j, double _factor, gsl_vector* _v)
+{
+    gsl_vector col = getKernelCol(_j);
+    MathUtils::add(_v, &col, _factor);
+}
+
+
+// Sum of the elements of a kernel column (its dot product with the bias column)
+double CImplicitBiasKernelMatrix::kernelColSum(int _j)
+{
+    gsl_vector col = getKernelCol(_j);
+    return MathUtils::dot(&col, m_vBias);
+}
+
+
+// Dot product between two kernel columns (both remain valid, see getCol)
+double CImplicitBiasKernelMatrix::kernelColColDot(int _i, int _j)
+{
+    gsl_vector col1 = getKernelCol(_i);
+    gsl_vector col2 = getKernelCol(_j);
+    return MathUtils::dot(&col1, &col2);
+}
+
+
+// Add the product of the kernel columns by _w, one column at the time (columns of null
+// weight are skipped)
+void CImplicitBiasKernelMatrix::kernelMvProduct(gsl_vector* _ptrVector, gsl_vector* _w)
+{
+    for (int j = 0; j < nbEx; ++j)
+    {
+        double w_j = gsl_vector_get(_w, j);
+        if (w_j != 0.0)
+            kernelColAxpy(j, w_j, _ptrVector);
+    }
+}
+
+
+// Constructor: wraps an already computed kernel matrix
+CDenseKernelMatrix::CDenseKernelMatrix(const CDataMatrix& _K, bool _bOwner /*= false*/)
+: CKernelMatrix()
+{
+    m_K      = _K;
+    m_bOwner = _bOwner;
+
+    Y    = _K.Y;
+    nbEx = _K.nbEx;
+    nbFt = _K.nbFt;
+}
+
+
+// Desallocate memory (only if the matrix is owned by this object)
+void CDenseKernelMatrix::free()
+{
+    if (m_bOwner)
+        m_K.free();
+
+    Y = NULL;
+}
+
+
+// Matrix by vector product (level-2 BLAS)
+void CDenseKernelMatrix::mvProduct(gsl_vector* _ptrVector, gsl_vector* _w)
+{
+    MathUtils::mvProduct(_ptrVector, m_K.X, _w);
+}
@@ -0,0 +1,147 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+#ifndef KERNEL_MATRIX_H
+#define KERNEL_MATRIX_H
+
+#include "DataMatrix.h"
+
+#include <gsl/gsl_vector.h>
+#include <vector>
+
+// Kernel matrix as seen by the learners, which only access it one column at the time.
+// Derived classes decide how the matrix is stored (see CDenseKernelMatrix, CCachedKernelMatrix).
+class CKernelMatrix
+{
+public:
+    // Matrix size [nb examples]x[nb columns], labels vector and rows weights (multiplicities of
+    // merged examples, see CDataMatrix::mergeDuplicates, NULL if all equal to 1)
+    // (declared 'public' for more commodity)
+    int             nbEx, nbFt;
+    gsl_vector*     Y;
+    gsl_vector*     W;
+
+public:
+    // Constructor / Destructor (the cycle of life!)
+    CKernelMatrix();
+    virtual ~CKernelMatrix()    { }
+
+    // Desallocate memory
+    virtual void        free()  { }
+
+    // Get a whole matrix column (column j). The returned vector remains valid
+    // at least until two other columns are requested.
+    virtual gsl_vector  getCol(int _j) = 0;
+
+    // Weight the rows in the dot products below (the vector is not owned by the matrix)
+    virtual void        setRowWeights(gsl_vector* _W)   { W = _W; }
+
+    // Operations on a column:  K[:,j] * v,   v += factor * K[:,j],   K[:,j] * K[:,j]
+    // The dot products are weighted by the rows weights W, if any:  sum of W_i*K[i,j]*v_i
+    virtual double      colDot(int _j, gsl_vector* _v);
+    virtual void        colAxpy(int _j, double _factor, gsl_vector* _v);
+    virtual double      colSqrNorm(int _j);
+
+    // Dot product between two columns:  K[:,i] * K[:,j]
+    virtual double      colColDot(int _i, int _j);
+
+    // Matrix by vector product: _ptrVector = K * _w
+    virtual void        mvProduct(gsl_vector* _ptrVector, gsl_vector* _w);
+
+    // A vector modified only by colAxpy (ie: the learners' distribution on examples) can be
+    // tracked by the matrix. A factored matrix then computes the dot products of the columns
+    // with that vector in its compact representation, and may defer the vector updates
+    // until flushTrackedVector() is called (which must precede any direct reading).
+    virtual void        trackVector(gsl_vector* _v)     { }
+    virtual void        flushTrackedVector()            { }
+
+    // A matrix stored out of memory reads ahead a column that will be requested soon.
+    // readAhead() announces the columns following position _pos of a visit order (indexes
+    // are taken modulo nbFt), so that they are read while the current one is processed.
+    virtual void        prefetchCol(int _j)             { }
+    void                readAhead(const std::vector<int>& _order, int _pos);
+};
+
+
+// Kernel matrix whose storage only holds the kernel values (train vs train): the bias column
+// (column nbEx, all ones) is implicit and handled here, whatever the storage. Derived classes
+// give the kernel columns (j < nbEx), and may override the operations on them.
+class CImplicitBiasKernelMatrix : public CKernelMatrix
+{
+public:
+    // Constructor / Destructor (the cycle of life!)
+    CImplicitBiasKernelMatrix();
+    virtual ~CImplicitBiasKernelMatrix()    { }
+
+    // Desallocate memory
+    virtual void        free();
+
+    // Get a whole matrix column (the bias column is shared, and must not be modified)
+    virtual gsl_vector  getCol(int _j);
+
+    // Operations on a column (the kernel columns are handled by the functions below)
+    virtual double      colDot(int _j, gsl_vector* _v);
+    virtual void        colAxpy(int _j, double _factor, gsl_vector* _v);
+    virtual double      colSqrNorm(int _j);
+    virtual double      colColDot(int _i, int _j);
+
+    // Matrix by vector product: _ptrVector = K * _w
+    virtual void        mvProduct(gsl_vector* _ptrVector, gsl_vector* _w);
+
+protected:
+    // Set the size of the matrix: _nbEx kernel columns plus the bias column
+    void                setSize(int _nbEx);
+
+    // Operations on the kernel columns (_i, _j < nbEx), without the rows weights. Only the
+    // dot products use the first nbEx elements of _v, the other elements are ignored.
+    virtual gsl_vector  getKernelCol(int _j) = 0;
+    virtual double      kernelColDot(int _j, gsl_vector* _v);
+    virtual void        kernelColAxpy(int _j, double _factor, gsl_vector* _v);
+    virtual double      kernelColSum(int _j);
+    virtual double      kernelColColDot(int _i, int _j);
+
+    // Add the product of the kernel columns by _w to _ptrVector (which holds the bias part)
+    virtual void        kernelMvProduct(gsl_vector* _ptrVector, gsl_vector* _w);
+
+    // Bias column
+    gsl_vector*         m_vBias;
+};
+
+
+// Kernel matrix entirely stored in memory (as computed by 'createKernelMatrix')
+class CDenseKernelMatrix : public CKernelMatrix
+{
+public:
+    // If _bOwner==true, the matrix memory is desallocated by free()
+    CDenseKernelMatrix(const CDataMatrix& _K, bool _bOwner = false);
+    virtual ~CDenseKernelMatrix()   { }
+
+    virtual void        free();
+
+    virtual gsl_vector  getCol(int _j)      { return m_K.getCol(_j); }
+    virtual void        mvProduct(gsl_vector* _ptrVector, gsl_vector* _w);
+
+    // Access the underlying matrix
+    const CDataMatrix&  getDataMatrix() const   { return m_K; }
+
+private:
+    // Kernel matrix
+    CDataMatrix     m_K;
+    bool            m_bOwner;
+};
+
+#endif // KERNEL_MATRIX_H
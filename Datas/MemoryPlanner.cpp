@@ -0,0 +1,212 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+
+#include "MemoryPlanner.h"
+
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+
+using namespace std;
+
+// Vectors of n values allocated by the learners (PBSC-N: weights (2), group weights, distances,
+// squared norms and margins)
+#define PLANNER_LEARNER_VECTORS     6
+
+// Rows of the train matrix computed at once by the single precision and packed matrices
+#define PLANNER_TILE_SIZE           256
+
+// Bytes by column of the cached matrix apart from the cache: bias value, slot index, LRU position
+// and LRU list node
+#define PLANNER_LRU_BYTES           (sizeof(double) + sizeof(int) + 4*sizeof(void*))
+
+// The column cache is chosen if it holds at least that fraction of the columns, and the Nystrom
+// approximation if it allows at least that number of landmarks
+#define PLANNER_MIN_CACHE_FRACTION  0.25
+#define PLANNER_MIN_LANDMARKS       10
+
+#define MB  (1024.0*1024.0)
+
+
+// Constructor
+CMemoryPlanner::CMemoryPlanner(double _limitMB)
+{
+    m_limit     = (size_t)(_limitMB * MB);
+    m_nbTrain   = 0;
+    m_nbCopies  = 1;
+    m_fixedSize = 0;
+    m_rep       = DENSE;
+    m_param     = 0.0;
+    m_totalSize = 0;
+}
+
+
+// Memory needed apart from the train matrix
+void CMemoryPlanner::setProblem(int _nbTrain, int _nbTest, size_t _dataBytes, int _nbCopies /*= 1*/)
+{
+    m_nbTrain  = _nbTrain;
+    m_nbCopies = _nbCopies;
+
+    size_t colBytes = (size_t)(_nbTrain+1) * sizeof(double);
+
+    m_fixedSize = _dataBytes
+                + (size_t)_nbCopies * _nbTest * colBytes
+                + PLANNER_LEARNER_VECTORS * colBytes;
+}
+
+
+// Memory of the train matrix, in bytes
+size_t CMemoryPlanner::trainSize(ERepresentation _rep, double _param /*= 0*/) const
+{
+    size_t n        = m_nbTrain;
+    size_t colBytes = n * sizeof(double);
+    size_t tile     = min(n, (size_t)PLANNER_TILE_SIZE) * colBytes;
+
+    switch (_rep)
+    {
+    case DENSE:
+        return m_nbCopies * n * (n+1) * sizeof(double);
+
+    case FLOAT:
+        return n * n * sizeof(float) + 2*colBytes + tile;
+
+    case PACKED:
+        return n * (n+1) / 2 * sizeof(double) + 2*colBytes + tile;
+
+    case PACKED_FLOAT:
+        return n * (n+1) / 2 * sizeof(float) + 2*colBytes + tile;
+
+    case CACHED:
+    {
+        size_t nbSlots = (size_t)min(_param * MB / colBytes, (double)n);
+        return max(nbSlots, (size_t)2) * colBytes + n * PLANNER_LRU_BYTES;
+    }
+
+    case NYSTROM:
+    {
+        // Peak of the factorization: C and A (n x m), W and U (m x m)
+        size_t m = min((size_t)_param, n);
+        return (2*n*m + 2*m*m) * sizeof(double) + 2*colBytes;
+    }
+
+    default:
+        return 0;
+    }
+}
+
+
+// Choose the first representation fitting in the limit
+bool CMemoryPlanner::plan(bool _bNystrom /*= true*/)
+{
+    const ERepresentation exact[] = { DENSE, PACKED, PACKED_FLOAT };
+
+    for (int r = 0; r < 3; ++r)
+    {
+        if ( check(exact[r]) )
+            return true;
+    }
+
+    size_t n        = m_nbTrain;
+    size_t colBytes = n * sizeof(double);
+    double avail    = (double)m_limit - (double)m_fixedSize;
+
+    // Column cache: the remaining memory, by whole columns
+    double nbSlots = floor( (avail - (double)n*PLANNER_LRU_BYTES) / colBytes );
+    nbSlots = min(nbSlots, (double)n);
+
+    double minSlots = max(PLANNER_MIN_CACHE_FRACTION * n, 2.0);
+
+    if ( nbSlots >= minSlots && check(CACHED, nbSlots * colBytes / MB) )
+        return true;
+
+    // Without Nystrom, the smallest cache tells the memory needed
+    if (!_bNystrom)
+    {
+        check( CACHED, ceil(minSlots) * colBytes / MB );
+        return false;
+    }
+
+    // Nystrom: largest m such that 16*(n*m + m^2) + 2*colBytes <= avail
+    double B = (avail - 2.0*colBytes) / (2*sizeof(double));
+    double m = (B > 0) ? floor( (sqrt((double)n*n + 4*B) - n) / 2 ) : 0;
+    m = min(m, (double)n);
+
+    if ( m >= min(PLANNER_MIN_LANDMARKS, m_nbTrain) && check(NYSTROM, m) )
+        return true;
+
+    // Nothing fits: the smallest representation tells the memory needed
+    check( NYSTROM, min(PLANNER_MIN_LANDMARKS, m_nbTrain) );
+    return false;
+}
+
+
+// Check a representation given by the user
+bool CMemoryPlanner::check(ERepresentation _rep, double _param /*= 0*/)
+{
+    m_rep       = _rep;
+    m_param     = _param;
+    m_totalSize = m_fixedSize + trainSize(_rep, _param);
+
+    return m_totalSize <= m_limit;
+}
+
+
+// Name of the representation of the last plan / check
+string CMemoryPlanner::getName() const
+{
+    ostringstream name;
+    name << fixed << setprecision(1);
+
+    switch (m_rep)
+    {
+    case DENSE:         name << "dense";                                            break;
+    case FLOAT:         name << "dense float";                                      break;
+    case PACKED:        name << "packed";                                           break;
+    case PACKED_FLOAT:  name << "packed float";                                     break;
+    case CACHED:        name << "cached (" << m_param << " MB)";                    break;
+    case NYSTROM:       name << "nystrom (" << (int)m_param << " landmarks)";       break;
+    default:            name << "not estimated";                                    break;
+    }
+
+    return name.str();
+}
+
+
+// Memory of a loaded dataset (features, bit-packed copy, labels, multiplicities), in bytes
+size_t CMemoryPlanner::datasetSize(const CDataMatrix& _X)
+{
+    size_t size = 0;
+
+    if (_X.X != NULL)
+        size += _X.X->size1 * _X.X->tda * sizeof(double);
+
+    if (_X.S != NULL)
+        size += (_X.S->nbRows+1) * sizeof(size_t) + _X.S->getNbNonZeros() * (sizeof(int) + sizeof(double));
+
+    if (_X.T != NULL)
+        size += 2 * (size_t)_X.T->nbRows * _X.T->nbWords * sizeof(uint64_t);
+
+    if (_X.Y != NULL)
+        size += _X.Y->size * sizeof(double);
+
+    if (_X.W != NULL)
+        size += _X.W->size * sizeof(double);
+
+    return size;
+}
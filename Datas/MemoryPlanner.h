@@ -0,0 +1,87 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+
+#ifndef MEMORY_PLANNER_H
+#define MEMORY_PLANNER_H
+
+#include "DataMatrix.h"
+
+#include <string>
+#include <cstddef>
+
+// Estimate of the memory needed to learn from a training set (datasets, train and test kernel
+// matrices, vectors of the learners), and choice of the train matrix representation fitting in
+// a memory limit. The representations are tried from the most accurate / fastest one:
+//  - DENSE        : n*(n+1) doubles
+//  - PACKED       : lower triangle in double precision, n*(n+1)/2 doubles (exact values)
+//  - PACKED_FLOAT : lower triangle in single precision, n*(n+1)/2 floats
+//  - CACHED       : columns computed on demand, the cache receiving the remaining memory (if it
+//                   holds a fair fraction of the columns, since the learners visit them all)
+//  - NYSTROM      : low-rank approximation, with as many landmarks as the remaining memory allows
+//                   (dense examples only)
+// FLOAT (the whole matrix in single precision) takes as much memory as PACKED, with less accurate
+// values: it is never chosen, but it is estimated when requested. OTHER stands for representations
+// whose size depends on the data (sparse, out-of-core, explicit features): they are not counted.
+class CMemoryPlanner
+{
+public:
+    enum ERepresentation { DENSE, FLOAT, PACKED, PACKED_FLOAT, CACHED, NYSTROM, OTHER };
+
+    // Constructor / Destructor (the cycle of life!)
+    CMemoryPlanner(double _limitMB);
+    ~CMemoryPlanner()   { }
+
+    // Memory needed apart from the train matrix: datasets (of '_dataBytes' bytes), test matrix
+    // (_nbTest x _nbTrain+1) and vectors of the learners. '_nbCopies' is the number of train and
+    // test matrices kept at the same time (ie: 2 for a gamma sweep, squared distances and kernel)
+    void        setProblem(int _nbTrain, int _nbTest, size_t _dataBytes, int _nbCopies = 1);
+
+    // Memory of the train matrix, in bytes. '_param' is the cache size in MB (CACHED) or the
+    // number of landmarks (NYSTROM)
+    size_t      trainSize(ERepresentation _rep, double _param = 0) const;
+
+    // Choose the first representation fitting in the limit (false if none does). NYSTROM is
+    // not tried if _bNystrom==false (ie: sparse examples, see CNystrom)
+    bool        plan(bool _bNystrom = true);
+
+    // Check a representation given by the user (false if it does not fit in the limit)
+    bool        check(ERepresentation _rep, double _param = 0);
+
+    // Result of the last plan / check
+    ERepresentation getRepresentation() const   { return m_rep; }
+    double          getParameter() const        { return m_param; }
+    size_t          getTotalSize() const        { return m_totalSize; }
+    size_t          getFixedSize() const        { return m_fixedSize; }
+    size_t          getLimit() const            { return m_limit; }
+    std::string     getName() const;
+
+    // Memory of a loaded dataset (features, bit-packed copy, labels, multiplicities), in bytes
+    static size_t   datasetSize(const CDataMatrix& _X);
+
+private:
+    size_t          m_limit;
+    int             m_nbTrain;
+    int             m_nbCopies;
+    size_t          m_fixedSize;
+
+    ERepresentation m_rep;
+    double          m_param;
+    size_t          m_totalSize;
+};
+
+#endif // MEMORY_PLANNER_H
@@ -0,0 +1,224 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+#include "Nystrom.h"
+#include "Utils/MathUtils.h"
+
+#include <gsl/gsl_eigen.h>
+#include <stdexcept>
+#include <algorithm>
+
+using namespace std;
+
+// Eigenvalues of W smaller than this fraction of the largest one are considered null
+#define NYSTROM_EIGEN_TOLERANCE 1e-10
+
+
+// Constructor
+CNystrom::CNystrom(const CKernel& _kernel, int _nbLandmarks, const string& _landmarks, unsigned long _seed)
+{
+    m_kernel      = _kernel;
+    m_nbLandmarks = _nbLandmarks;
+    m_seed        = _seed;
+
+    if (_landmarks == "UNIFORM")
+        m_method = UNIFORM;
+    else if (_landmarks == "KMEANS++")
+        m_method = KMEANSPP;
+    else
+        throw logic_error("[CNystrom::CNystrom] Unknown landmarks selection method '" + _landmarks + "'.");
+
+    if (m_nbLandmarks < 1)
+        throw logic_error("[CNystrom::CNystrom] The number of landmarks must be positive.");
+}
+
+
+// Compute the factor A of the kernel matrix of a dataset:  K ~= A * A'
+CDataMatrix CNystrom::createFactor(const CDataMatrix& _X)
+{
+    if ( _X.isSparse() )
+        throw logic_error("[CNystrom::createFactor] Sparse features are not supported.");
+
+    int m = min(m_nbLandmarks, _X.nbEx);
+
+    gsl_rng* rng = gsl_rng_alloc(gsl_rng_mt19937);
+    gsl_rng_set(rng, m_seed);
+
+    // Kernel values between the examples and the landmarks
+    gsl_matrix* C = gsl_matrix_alloc(_X.nbEx, m);
+    m_landmarks.clear();
+
+    if (m_method == KMEANSPP)
+        fillKMeansPP(_X, C, rng);
+    else
+        fillUniform(_X, C, rng);
+
+    gsl_rng_free(rng);
+
+    // W is made of the landmarks rows of C: W = U S U'
+    gsl_matrix* W     = gsl_matrix_alloc(m, m);
+    gsl_matrix* U     = gsl_matrix_alloc(m, m);
+    gsl_vector* vEval = gsl_vector_alloc(m);
+
+    for (int k = 0; k < m; ++k)
+    {
+        gsl_vector row = gsl_matrix_row(C, m_landmarks[k]).vector;
+        gsl_matrix_set_row(W, k, &row);
+    }
+
+    gsl_eigen_symmv_workspace* work = gsl_eigen_symmv_alloc(m);
+    gsl_eigen_symmv(W, vEval, U, work);
+    gsl_eigen_symmv_free(work);
+
+    // Keep the eigenvectors of non null eigenvalues, scaled by S^(-1/2)
+    double maxEval = gsl_vector_max(vEval);
+    int    rank    = 0;
+
+    for (int k = 0; k < m; ++k)
+    {
+        double eval = gsl_vector_get(vEval, k);
+        if (eval <= NYSTROM_EIGEN_TOLERANCE * maxEval)
+            continue;
+
+        gsl_vector src = gsl_matrix_column(U, k).vector;
+        gsl_vector dst = gsl_matrix_column(W, rank).vector;
+        gsl_vector_memcpy(&dst, &src);
+        gsl_vector_scale(&dst, 1.0/sqrt(eval));
+        ++rank;
+    }
+
+    if (rank == 0)
+        throw logic_error("[CNystrom::createFactor] The landmarks kernel matrix is null.");
+
+    // A = C * U * S^(-1/2)
+    CDataMatrix A;
+    A.init(_X.nbEx, rank, (_X.Y != NULL));
+
+    gsl_matrix_view US = gsl_matrix_submatrix(W, 0, 0, m, rank);
+    MathUtils::matrixProduct(A.X, C, &US.matrix);
+
+    if (_X.Y != NULL)
+        gsl_vector_memcpy(A.Y, _X.Y);
+
+    gsl_matrix_free(C);
+    gsl_matrix_free(W);
+    gsl_matrix_free(U);
+    gsl_vector_free(vEval);
+
+    return A;
+}
+
+
+// Uniform selection: m distinct random examples (partial Fisher-Yates shuffle)
+void CNystrom::fillUniform(const CDataMatrix& _X, gsl_matrix* _C, gsl_rng* _rng)
+{
+    int m = _C->size2;
+
+    vector<int> indices(_X.nbEx);
+    for (int i = 0; i < _X.nbEx; ++i)
+        indices[i] = i;
+
+    for (int k = 0; k < m; ++k)
+        swap( indices[k], indices[ k + gsl_rng_uniform_int(_rng, _X.nbEx-k) ] );
+
+    // All columns are computed at once (landmarks as a dataset)
+    CDataMatrix L;
+    L.init(m, _X.nbFt, false);
+
+    for (int k = 0; k < m; ++k)
+    {
+        m_landmarks.push_back( indices[k] );
+
+        gsl_vector x = _X.getRow( indices[k] );
+        gsl_matrix_set_row(L.X, k, &x);
+    }
+
+    m_kernel.fillKernelMatrix(_X, L, _C);
+
+    L.free();
+}
+
+
+// k-means++ seeding: each new landmark is drawn with a probability proportional to its squared
+// distance (in the kernel feature space) to the nearest landmark already selected:
+//      d(x,l)^2 = k(x,x) + k(l,l) - 2 k(x,l)
+// The kernel values k(x,l) needed are exactly the columns of C.
+void CNystrom::fillKMeansPP(const CDataMatrix& _X, gsl_matrix* _C, gsl_rng* _rng)
+{
+    int m = _C->size2;
+
+    gsl_vector* vDiag    = gsl_vector_alloc(_X.nbEx);
+    gsl_vector* vMinDist = gsl_vector_alloc(_X.nbEx);
+    gsl_vector_set_all(vMinDist, HUGE_VAL);
+
+    gsl_vector x;
+    for (int i = 0; i < _X.nbEx; ++i)
+    {
+        x = _X.getRow(i);
+        gsl_vector_set(vDiag, i, m_kernel.kernel(&x, &x));
+    }
+
+    int index = gsl_rng_uniform_int(_rng, _X.nbEx);
+
+    for (int k = 0; k < m; ++k)
+    {
+        m_landmarks.push_back(index);
+        fillColumn(_X, _C, k, index);
+
+        // Update the distances to the nearest landmark
+        double total = 0.0;
+        for (int i = 0; i < _X.nbEx; ++i)
+        {
+            double dist = gsl_vector_get(vDiag, i) + gsl_vector_get(vDiag, index) - 2*gsl_matrix_get(_C, i, k);
+            dist = max( 0.0, min(dist, gsl_vector_get(vMinDist, i)) );
+            gsl_vector_set(vMinDist, i, dist);
+            total += dist;
+        }
+
+        // Every example is (numerically) a landmark: pick the next ones uniformly
+        if (total <= 0.0)
+        {
+            for (int i = 0; i < _X.nbEx; ++i)
+                gsl_vector_set(vMinDist, i, find(m_landmarks.begin(), m_landmarks.end(), i) == m_landmarks.end());
+            total = MathUtils::sum(vMinDist);
+        }
+
+        // Draw the next landmark
+        double r = gsl_rng_uniform(_rng) * total;
+        index = 0;
+        while (index < _X.nbEx-1 && (r -= gsl_vector_get(vMinDist, index)) > 0.0)
+            ++index;
+    }
+
+    gsl_vector_free(vDiag);
+    gsl_vector_free(vMinDist);
+}
+
+
+// Compute column k of C: kernel values between the examples and landmark _index
+void CNystrom::fillColumn(const CDataMatrix& _X, gsl_matrix* _C, int _k, int _index)
+{
+    CDataMatrix landmark;
+    landmark.nbEx = 1;
+    landmark.nbFt = _X.nbFt;
+
+    gsl_matrix_view row = gsl_matrix_submatrix(_X.X, _index, 0, 1, _X.nbFt);
+    landmark.X = &row.matrix;
+
+    gsl_matrix_view col = gsl_matrix_submatrix(_C, 0, _k, _X.nbEx, 1);
+    m_kernel.fillKernelMatrix(_X, landmark, &col.matrix);
+}
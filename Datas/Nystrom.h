@@ -0,0 +1,66 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+#ifndef NYSTROM_H
+#define NYSTROM_H
+
+#include "Kernel.h"
+
+#include <gsl/gsl_rng.h>
+#include <string>
+#include <vector>
+
+// Nystrom low-rank approximation of a kernel matrix:  K ~= C * W+ * C'
+//  - C : kernel values between the n examples and m landmark examples  [n]x[m]
+//  - W : kernel values between the landmarks                            [m]x[m]
+// It is given as a factor A = C * U * S^(-1/2) (W = U S U', null eigenvalues dropped),
+// so that K ~= A * A' (see CFactoredKernelMatrix). Memory and time are O(n*m).
+class CNystrom
+{
+public:
+    // Landmarks selection methods
+    enum ELandmarks { UNIFORM, KMEANSPP };
+
+    // Constructor / Destructor (the cycle of life!)
+    // _nbLandmarks : number of landmarks m (at most the number of examples)
+    // _landmarks   : "UNIFORM" (random examples) or "KMEANS++" (k-means++ seeding in the
+    //                kernel feature space: far examples from the current landmarks are preferred)
+    CNystrom(const CKernel& _kernel, int _nbLandmarks, const std::string& _landmarks, unsigned long _seed);
+    ~CNystrom() { }
+
+    // Compute the factor A of the kernel matrix of a dataset (labels are copied)
+    CDataMatrix createFactor(const CDataMatrix& _X);
+
+    // Indices of the selected landmarks (after createFactor)
+    const std::vector<int>& getLandmarks() const    { return m_landmarks; }
+
+private:
+    // Fill the columns of C (and select the landmarks)
+    void        fillUniform(const CDataMatrix& _X, gsl_matrix* _C, gsl_rng* _rng);
+    void        fillKMeansPP(const CDataMatrix& _X, gsl_matrix* _C, gsl_rng* _rng);
+
+    // Compute column k of C, ie the kernel values between the examples and landmark _index
+    void        fillColumn(const CDataMatrix& _X, gsl_matrix* _C, int _k, int _index);
+
+    CKernel             m_kernel;
+    int                 m_nbLandmarks;
+    ELandmarks          m_method;
+    unsigned long       m_seed;
+    std::vector<int>    m_landmarks;
+};
+
+#endif // NYSTROM_H
@@ -0,0 +1,105 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+
+#include "OutOfCoreKernelMatrix.h"
+
+#include <algorithm>
+#include <sstream>
+#include <cstdio>
+#include <unistd.h>
+
+using namespace std;
+
+// Number of columns computed at once
+#define OUT_OF_CORE_TILE_SIZE 256
+
+
+// Constructor: computes the whole matrix into the scratch file
+COutOfCoreKernelMatrix::COutOfCoreKernelMatrix(const CDataMatrix& _data, const CKernel& _kernel, CMappedFile* _pFile)
+: CImplicitBiasKernelMatrix()
+{
+    Y    = _data.Y;
+    setSize(_data.nbEx);
+
+    m_pFile = _pFile;
+
+    for (int j0 = 0; j0 < nbEx; j0 += OUT_OF_CORE_TILE_SIZE)
+        computeCols(_data, _kernel, j0, min(OUT_OF_CORE_TILE_SIZE, nbEx - j0));
+}
+
+
+// Create and map the scratch file
+CMappedFile* COutOfCoreKernelMatrix::createScratchFile(const std::string& _sScratchDir, int _nbEx)
+{
+    ostringstream filename;
+    filename << _sScratchDir << "/K_scratch" << getpid() << ".kmat";
+
+    CMappedFile* pFile = new CMappedFile();
+    if ( !pFile->create( filename.str().c_str(), (size_t)_nbEx*_nbEx*sizeof(double) ) )
+    {
+        delete pFile;
+        return NULL;
+    }
+
+    // The mapping keeps the file content until it is released
+    remove( filename.str().c_str() );
+
+    return pFile;
+}
+
+
+// Desallocate memory (the training examples are not owned by this object)
+void COutOfCoreKernelMatrix::free()
+{
+    CImplicitBiasKernelMatrix::free();
+
+    if (m_pFile != NULL) delete m_pFile;
+
+    m_pFile = NULL;
+    Y       = NULL;
+}
+
+
+// Get a kernel column
+gsl_vector COutOfCoreKernelMatrix::getKernelCol(int _j)
+{
+    double* col = (double*)m_pFile->data() + (size_t)_j*nbEx;
+    return gsl_vector_view_array(col, nbEx).vector;
+}
+
+
+// Read ahead column j
+void COutOfCoreKernelMatrix::prefetchCol(int _j)
+{
+    if (_j < nbEx)
+        m_pFile->prefetch( (size_t)_j*nbEx*sizeof(double), nbEx*sizeof(double) );
+}
+
+
+// Compute a tile of columns. The matrix being symmetric, the columns [_j0, _j0+_nbCols) are
+// the kernel values between the examples [_j0, _j0+_nbCols) and all the examples, ie a
+// (_nbCols x nbEx) row-major block of the file.
+void COutOfCoreKernelMatrix::computeCols(const CDataMatrix& _data, const CKernel& _kernel, int _j0, int _nbCols)
+{
+    CKernel kernel = _kernel;
+
+    double* block = (double*)m_pFile->data() + (size_t)_j0*nbEx;
+    gsl_matrix_view cols = gsl_matrix_view_array(block, _nbCols, nbEx);
+
+    kernel.fillKernelRows(_data, _j0, _nbCols, &cols.matrix);
+}
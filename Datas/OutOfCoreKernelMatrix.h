@@ -0,0 +1,66 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+
+#ifndef OUT_OF_CORE_KERNEL_MATRIX_H
+#define OUT_OF_CORE_KERNEL_MATRIX_H
+
+#include "KernelMatrix.h"
+#include "Kernel.h"
+#include "Utils/MappedFile.h"
+
+#include <string>
+
+// Training kernel matrix (train vs train, plus the bias column) stored in a scratch file mapped
+// in memory, for matrices exceeding the memory. The matrix is computed once, one tile of columns
+// at the time, and each column is contiguous in the file: a column requested by the learner is
+// read sequentially, and the columns visited next can be read ahead (see prefetchCol). The
+// scratch file is removed as soon as it is mapped, so it never outlives the process.
+class COutOfCoreKernelMatrix : public CImplicitBiasKernelMatrix
+{
+public:
+    // Constructor / Destructor (the cycle of life!)
+    // _data       : training examples (features matrix and labels)
+    // _pFile      : scratch file given by createScratchFile (owned by this object)
+    COutOfCoreKernelMatrix(const CDataMatrix& _data, const CKernel& _kernel, CMappedFile* _pFile);
+    virtual ~COutOfCoreKernelMatrix()   { }
+
+    // Create and map the scratch file of the kernel matrix of _nbEx examples, in the directory
+    // _sScratchDir (preferably on a fast disk). Returns NULL if the file can not be created.
+    static CMappedFile* createScratchFile(const std::string& _sScratchDir, int _nbEx);
+
+    // Desallocate memory (and the scratch file)
+    virtual void        free();
+
+    // Read ahead column j
+    virtual void        prefetchCol(int _j);
+
+    // Size of the scratch file, in bytes
+    size_t              getFileSize() const     { return m_pFile != NULL ? m_pFile->size() : 0; }
+
+protected:
+    // Get a kernel column (a view into the mapped file)
+    virtual gsl_vector  getKernelCol(int _j);
+
+    // Compute the columns [_j0, _j0+_nbCols) of the kernel matrix into the mapped file
+    void                computeCols(const CDataMatrix& _data, const CKernel& _kernel, int _j0, int _nbCols);
+
+    // Mapped scratch file (column j starts at element j*nbEx)
+    CMappedFile*        m_pFile;
+};
+
+#endif // OUT_OF_CORE_KERNEL_MATRIX_H
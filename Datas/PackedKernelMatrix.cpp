@@ -0,0 +1,157 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+
+#include "PackedKernelMatrix.h"
+
+#include <algorithm>
+
+using namespace std;
+
+// Number of rows computed at once (in double precision)
+#define PACKED_KERNEL_TILE_SIZE 256
+
+
+// Constructor: computes the lower triangle, one tile of rows at the time
+// (each tile only against the examples up to its last row)
+template <class T>
+CPackedKernelMatrix<T>::CPackedKernelMatrix(const CDataMatrix& _data, const CKernel& _kernel)
+: CImplicitBiasKernelMatrix()
+{
+    CKernel kernel = _kernel;
+
+    Y    = _data.Y;
+    setSize(_data.nbEx);
+
+    m_values  = new T[(size_t)nbEx*(nbEx+1)/2];
+    m_cols    = gsl_matrix_alloc(2, nbEx);
+    m_nextCol = 0;
+
+    gsl_matrix* tile = gsl_matrix_alloc(min(PACKED_KERNEL_TILE_SIZE, nbEx), nbEx);
+
+    for (int i0 = 0; i0 < nbEx; i0 += PACKED_KERNEL_TILE_SIZE)
+    {
+        int nbRows = min(PACKED_KERNEL_TILE_SIZE, nbEx - i0);
+
+        gsl_matrix_view rows = gsl_matrix_submatrix(tile, 0, 0, nbRows, i0 + nbRows);
+        kernel.fillKernelRows(_data, i0, nbRows, &rows.matrix);
+
+        for (int i = 0; i < nbRows; ++i)
+        {
+            const double* src = gsl_matrix_const_ptr(&rows.matrix, i, 0);
+            copy(src, src + i0+i+1, m_values + offset(i0+i));
+        }
+    }
+
+    gsl_matrix_free(tile);
+}
+
+
+// Desallocate memory (the training examples are not owned by this object)
+template <class T>
+void CPackedKernelMatrix<T>::free()
+{
+    CImplicitBiasKernelMatrix::free();
+
+    delete[] m_values;
+    if (m_cols != NULL) gsl_matrix_free(m_cols);
+
+    m_values = NULL;
+    m_cols   = NULL;
+    Y        = NULL;
+}
+
+
+// Get a kernel column
+template <class T>
+gsl_vector CPackedKernelMatrix<T>::getKernelCol(int _j)
+{
+    gsl_vector col = gsl_matrix_row(m_cols, m_nextCol).vector;
+    m_nextCol = 1 - m_nextCol;
+
+    copy(row(_j), row(_j) + _j+1, col.data);
+
+    size_t pos = offset(_j+1) + _j;
+    for (int i = _j+1; i < nbEx; pos += ++i)
+        col.data[i] = m_values[pos];
+
+    return col;
+}
+
+
+// Dot product between a kernel column and a vector
+template <class T>
+double CPackedKernelMatrix<T>::kernelColDot(int _j, gsl_vector* _v)
+{
+    const double* v      = _v->data;
+    size_t        stride = _v->stride;
+    double        result = 0.0;
+
+    const T* k = row(_j);
+    for (int i = 0; i <= _j; ++i)
+        result += k[i] * v[i*stride];
+
+    size_t pos = offset(_j+1) + _j;
+    for (int i = _j+1; i < nbEx; pos += ++i)
+        result += m_values[pos] * v[i*stride];
+
+    return result;
+}
+
+
+// Add a multiple of a kernel column to a vector
+template <class T>
+void CPackedKernelMatrix<T>::kernelColAxpy(int _j, double _factor, gsl_vector* _v)
+{
+    double* v      = _v->data;
+    size_t  stride = _v->stride;
+
+    const T* k = row(_j);
+    for (int i = 0; i <= _j; ++i)
+        v[i*stride] += _factor * k[i];
+
+    size_t pos = offset(_j+1) + _j;
+    for (int i = _j+1; i < nbEx; pos += ++i)
+        v[i*stride] += _factor * m_values[pos];
+}
+
+
+// Add the product of the kernel columns by _w: each value K[i,j] (j < i) contributes to
+// elements i and j
+template <class T>
+void CPackedKernelMatrix<T>::kernelMvProduct(gsl_vector* _ptrVector, gsl_vector* _w)
+{
+    for (int i = 0; i < nbEx; ++i)
+    {
+        const T* k   = row(i);
+        double   w_i = gsl_vector_get(_w, i);
+        double   sum = k[i] * w_i;
+
+        for (int j = 0; j < i; ++j)
+        {
+            sum += k[j] * gsl_vector_get(_w, j);
+            *gsl_vector_ptr(_ptrVector, j) += k[j] * w_i;
+        }
+
+        *gsl_vector_ptr(_ptrVector, i) += sum;
+    }
+}
+
+
+// Value types of the kernel matrices
+template class CPackedKernelMatrix<double>;
+template class CPackedKernelMatrix<float>;
@@ -0,0 +1,70 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+
+#ifndef PACKED_KERNEL_MATRIX_H
+#define PACKED_KERNEL_MATRIX_H
+
+#include "KernelMatrix.h"
+#include "Kernel.h"
+
+#include <gsl/gsl_matrix.h>
+#include <gsl/gsl_vector.h>
+
+// Training kernel matrix (train vs train, plus the bias column) where only the lower triangle of
+// the symmetric matrix is stored, in packed form: row i holds K[i,0..i] and starts at element
+// i(i+1)/2. The bias column is implicit. Memory is n(n+1)/2 values instead of n(n+1).
+// Column j is made of row j (contiguous) and of the elements K[i,j], i > j, of the next rows:
+// the column operations read both parts in place, getCol gathers them into a buffer.
+// T is the type of the stored values (double or float; computations are in double precision).
+template <class T>
+class CPackedKernelMatrix : public CImplicitBiasKernelMatrix
+{
+public:
+    // Constructor / Destructor (the cycle of life!)
+    CPackedKernelMatrix(const CDataMatrix& _data, const CKernel& _kernel);
+    virtual ~CPackedKernelMatrix()  { }
+
+    // Desallocate memory
+    virtual void        free();
+
+    // Memory used by the matrix values, in bytes
+    size_t              getSize() const     { return (size_t)nbEx*(nbEx+1)/2 * sizeof(T); }
+
+protected:
+    // Get a kernel column (gathered in one of two buffers)
+    virtual gsl_vector  getKernelCol(int _j);
+
+    // Operations on a kernel column, read in place
+    virtual double      kernelColDot(int _j, gsl_vector* _v);
+    virtual void        kernelColAxpy(int _j, double _factor, gsl_vector* _v);
+
+    // Product of the kernel columns by a vector (each stored value is read once)
+    virtual void        kernelMvProduct(gsl_vector* _ptrVector, gsl_vector* _w);
+
+    // Row i of the lower triangle (i+1 elements), and its position
+    static size_t       offset(int _i)      { return (size_t)_i*(_i+1)/2; }
+    const T*            row(int _i) const   { return m_values + offset(_i); }
+
+    T*                  m_values;
+
+    // Buffers returned by getCol
+    gsl_matrix*         m_cols;
+    int                 m_nextCol;
+};
+
+#endif // PACKED_KERNEL_MATRIX_H
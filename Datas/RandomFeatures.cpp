@@ -0,0 +1,120 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+#include "RandomFeatures.h"
+#include "Utils/MathUtils.h"
+
+#include <gsl/gsl_rng.h>
+#include <gsl/gsl_randist.h>
+#include <stdexcept>
+#include <cmath>
+#include <ctime>
+
+using namespace std;
+
+
+// Constructor
+CRandomFeatures::CRandomFeatures(const StrValueMap& _map, CKernel _kernel)
+: CFeatureMap()
+{
+    StrValueMap kMap = _kernel.serialize();
+    StrValueMap::const_iterator it;
+
+    if ( (string)kMap["kernel"] != "RBF" )
+        throw logic_error("[CRandomFeatures::CRandomFeatures] Random Fourier features require the RBF kernel.");
+
+    m_kernel     = _kernel;
+    m_gamma      = kMap["kernel.gamma"];
+    m_nbFeatures = 0;
+    m_seed       = time(NULL);
+    m_W          = NULL;
+    m_b          = NULL;
+
+    if ( (it = _map.find("rff.D")) != _map.end() )         m_nbFeatures = it->second;
+    if ( (it = _map.find("seed")) != _map.end() )          m_seed       = (int)it->second;
+    if ( (it = _map.find("rff.seed")) != _map.end() )      m_seed       = (int)it->second;
+
+    if (m_nbFeatures < 1)
+        throw logic_error("[CRandomFeatures::CRandomFeatures] The number of features must be positive.");
+}
+
+
+// Desallocate memory
+void CRandomFeatures::free()
+{
+    if (m_W != NULL) gsl_matrix_free(m_W);
+    if (m_b != NULL) gsl_vector_free(m_b);
+
+    m_W = NULL;
+    m_b = NULL;
+}
+
+
+// Save the features parameters (with the kernel ones)
+StrValueMap CRandomFeatures::serialize()
+{
+    StrValueMap map = m_kernel.serialize();
+
+    map["rff.D"]    = m_nbFeatures;
+    map["rff.seed"] = (int)m_seed;
+
+    return map;
+}
+
+
+// Draw the random directions W and offsets b (always in the same order for a given seed)
+void CRandomFeatures::draw(int _nbInputs)
+{
+    free();
+
+    m_W = gsl_matrix_alloc(m_nbFeatures, _nbInputs);
+    m_b = gsl_vector_alloc(m_nbFeatures);
+
+    gsl_rng* rng = gsl_rng_alloc(gsl_rng_mt19937);
+    gsl_rng_set(rng, m_seed);
+
+    double sigma = sqrt(2*m_gamma);
+
+    for (int k = 0; k < m_nbFeatures; ++k)
+        for (int i = 0; i < _nbInputs; ++i)
+            gsl_matrix_set(m_W, k, i, gsl_ran_gaussian(rng, sigma));
+
+    for (int k = 0; k < m_nbFeatures; ++k)
+        gsl_vector_set(m_b, k, 2*M_PI*gsl_rng_uniform(rng));
+
+    gsl_rng_free(rng);
+}
+
+
+// Fill the features: Z = sqrt(2/D) * cos(X*W' + b)
+void CRandomFeatures::fill(const CDataMatrix& _X, gsl_matrix* _Z)
+{
+    if (m_W == NULL || (int)m_W->size2 != _X.nbFt)
+        draw(_X.nbFt);
+
+    MathUtils::matrixProduct(_Z, _X.X, m_W, false, true);
+
+    double scale = sqrt(2.0/m_nbFeatures);
+
+    for (int i = 0; i < _X.nbEx; ++i)
+    {
+        double* row = gsl_matrix_ptr(_Z, i, 0);
+
+        for (int k = 0; k < m_nbFeatures; ++k)
+            row[k] = scale * cos( row[k] + gsl_vector_get(m_b, k) );
+    }
+}
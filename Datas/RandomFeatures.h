@@ -0,0 +1,66 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+#ifndef RANDOM_FEATURES_H
+#define RANDOM_FEATURES_H
+
+#include "FeatureMap.h"
+
+#include <gsl/gsl_matrix.h>
+#include <gsl/gsl_vector.h>
+
+// Random Fourier features of the RBF kernel k(x,y) = exp(-gamma ||x-y||^2):
+//      z(x) = sqrt(2/D) * cos(W*x + b),   W[k,:] ~ N(0, 2*gamma*I),   b[k] ~ U[0, 2*pi]
+// so that z(x)*z(y) ~= k(x,y). The D features are entirely determined by (gamma, D, seed):
+// a classifier saved with these parameters can recreate them (see serialize).
+class CRandomFeatures : public CFeatureMap
+{
+public:
+    // Constructor / Destructor (the cycle of life!)
+    // _map : 'rff.D' (number of features) and 'rff.seed' (or 'seed', default=<System time>)
+    CRandomFeatures(const StrValueMap& _map, CKernel _kernel);
+    virtual ~CRandomFeatures()  { free(); }
+
+    // Desallocate memory
+    void                free();
+
+    virtual StrValueMap serialize();
+
+    virtual std::string getName()                       { return "random Fourier features"; }
+    virtual int         getNbFeatures(int /*_nbInputs*/) { return m_nbFeatures; }
+
+protected:
+    virtual void        fill(const CDataMatrix& _X, gsl_matrix* _Z);
+
+private:
+    // Not copyable (random directions are owned)
+    CRandomFeatures(const CRandomFeatures&);
+    CRandomFeatures& operator=(const CRandomFeatures&);
+
+    // Draw the random directions and offsets for inputs of dimension _nbInputs
+    void                draw(int _nbInputs);
+
+    CKernel         m_kernel;
+    double          m_gamma;
+    int             m_nbFeatures;
+    unsigned long   m_seed;
+
+    gsl_matrix*     m_W;    // [D]x[nb input features]
+    gsl_vector*     m_b;    // [D]
+};
+
+#endif // RANDOM_FEATURES_H
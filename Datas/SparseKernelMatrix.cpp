@@ -0,0 +1,270 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+
+#include "SparseKernelMatrix.h"
+#include "KdTree.h"
+#include "Utils/MathUtils.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <cmath>
+
+using namespace std;
+
+// Number of rows computed at once (sparse examples)
+#define SPARSE_KERNEL_BLOCK_SIZE 256
+
+
+// Nonzero values of each row: (column, value) pairs
+typedef vector< vector< pair<int,double> > > RowsOfPairs;
+
+
+// Constructor: computes the kernel values above the cutoff
+CSparseKernelMatrix::CSparseKernelMatrix(const CDataMatrix& _data, const CKernel& _kernel, double _cutoff)
+: CImplicitBiasKernelMatrix()
+{
+    StrValueMap kMap = CKernel(_kernel).serialize();
+
+    if ( (string)kMap["kernel"] != "RBF" )
+        throw logic_error("[CSparseKernelMatrix::CSparseKernelMatrix] A kernel cutoff requires the RBF kernel.");
+
+    if (_cutoff <= 0.0 || _cutoff >= 1.0)
+        throw logic_error("[CSparseKernelMatrix::CSparseKernelMatrix] The kernel cutoff must be in (0,1).");
+
+    m_data   = _data;
+    m_kernel = _kernel;
+
+    Y    = _data.Y;
+    setSize(_data.nbEx);
+
+    double gamma = kMap["kernel.gamma"];
+
+    if ( _data.isSparse() )
+        computeByBlocks(_data, _kernel, _cutoff);
+    else
+        computeWithTree(_data, _kernel.getNbThreads(), gamma, -log(_cutoff) / gamma);
+
+    m_cols = gsl_matrix_calloc(2, nbEx);
+    m_colOfBuffer[0] = -1;
+    m_colOfBuffer[1] = -1;
+    m_nextCol = 0;
+}
+
+
+// Pack rows of (column, value) pairs into a CSR matrix (columns sorted on each row)
+static void packRows(RowsOfPairs& _rows, int _nbCols, CSparseMatrix& _K)
+{
+    size_t nbNonZeros = 0;
+    for (size_t i = 0; i < _rows.size(); ++i)
+        nbNonZeros += _rows[i].size();
+
+    _K.init(_rows.size(), _nbCols, nbNonZeros);
+
+    size_t k = 0;
+    for (size_t i = 0; i < _rows.size(); ++i)
+    {
+        sort(_rows[i].begin(), _rows[i].end());
+
+        for (size_t l = 0; l < _rows[i].size(); ++l, ++k)
+        {
+            _K.colIndex[k] = _rows[i][l].first;
+            _K.values[k]   = _rows[i][l].second;
+        }
+
+        _K.rowStart[i+1] = k;
+        vector< pair<int,double> >().swap(_rows[i]);
+    }
+}
+
+
+// Dense examples: neighbors within the cutoff radius, found with a k-d tree
+void CSparseKernelMatrix::computeWithTree(const CDataMatrix& _data, int _nbThreads, double _gamma, double _sqrRadius)
+{
+    CKdTree     tree(_data.X);
+    RowsOfPairs rows(nbEx);
+
+    #pragma omp parallel num_threads(_nbThreads)
+    {
+        vector<int>     indexes;
+        vector<double>  sqrDists;
+
+        #pragma omp for schedule(dynamic)
+        for (int i = 0; i < nbEx; ++i)
+        {
+            indexes.clear();
+            sqrDists.clear();
+            tree.radiusSearch(gsl_matrix_const_ptr(_data.X, i, 0), _sqrRadius, indexes, sqrDists);
+
+            rows[i].resize(indexes.size());
+            for (size_t l = 0; l < indexes.size(); ++l)
+                rows[i][l] = make_pair(indexes[l], exp(-1 * _gamma * sqrDists[l]));
+        }
+    }
+
+    packRows(rows, nbEx, m_K);
+}
+
+
+// Sparse examples: full rows computed one block at the time, then thresholded
+void CSparseKernelMatrix::computeByBlocks(const CDataMatrix& _data, const CKernel& _kernel, double _cutoff)
+{
+    CKernel     kernel = _kernel;
+    RowsOfPairs rows(nbEx);
+    gsl_matrix* block  = gsl_matrix_alloc(min(SPARSE_KERNEL_BLOCK_SIZE, nbEx), nbEx);
+
+    for (int i0 = 0; i0 < nbEx; i0 += SPARSE_KERNEL_BLOCK_SIZE)
+    {
+        int nbRows = min(SPARSE_KERNEL_BLOCK_SIZE, nbEx - i0);
+
+        CSparseMatrix sView = _data.S->rows(i0, nbRows);
+        CDataMatrix   examples;
+        examples.nbEx = nbRows;
+        examples.nbFt = _data.nbFt;
+        examples.S    = &sView;
+
+        gsl_matrix_view Kblock = gsl_matrix_submatrix(block, 0, 0, nbRows, nbEx);
+        kernel.fillKernelMatrix(examples, _data, &Kblock.matrix);
+
+        for (int i = 0; i < nbRows; ++i)
+        {
+            const double* row = gsl_matrix_const_ptr(block, i, 0);
+
+            for (int j = 0; j < nbEx; ++j)
+            {
+                if (row[j] >= _cutoff)
+                    rows[i0+i].push_back( make_pair(j, row[j]) );
+            }
+        }
+
+        examples.S = NULL;
+    }
+
+    gsl_matrix_free(block);
+    packRows(rows, nbEx, m_K);
+}
+
+
+// Desallocate memory (the training examples are not owned by this object)
+void CSparseKernelMatrix::free()
+{
+    CImplicitBiasKernelMatrix::free();
+
+    m_K.free();
+
+    if (m_cols != NULL) gsl_matrix_free(m_cols);
+    m_cols = NULL;
+    Y      = NULL;
+}
+
+
+// Get a kernel column: the column is scattered into the oldest buffer (after clearing the
+// column previously scattered there)
+gsl_vector CSparseKernelMatrix::getKernelCol(int _j)
+{
+    gsl_vector col = gsl_matrix_row(m_cols, m_nextCol).vector;
+    int&       old = m_colOfBuffer[m_nextCol];
+    m_nextCol = 1 - m_nextCol;
+
+    if (old >= 0)
+        m_K.clear(old, col.data);
+
+    m_K.scatter(_j, col.data);
+
+    old = _j;
+    return col;
+}
+
+
+// Dot product between a kernel column and a vector
+double CSparseKernelMatrix::kernelColDot(int _j, gsl_vector* _v)
+{
+    double result = 0.0;
+
+    for (size_t k = m_K.rowStart[_j]; k < m_K.rowStart[_j+1]; ++k)
+        result += m_K.values[k] * _v->data[m_K.colIndex[k]*_v->stride];
+
+    return result;
+}
+
+
+// Add a multiple of a kernel column to a vector
+void CSparseKernelMatrix::kernelColAxpy(int _j, double _factor, gsl_vector* _v)
+{
+    for (size_t k = m_K.rowStart[_j]; k < m_K.rowStart[_j+1]; ++k)
+        _v->data[m_K.colIndex[k]*_v->stride] += _factor * m_K.values[k];
+}
+
+
+// Sum of the elements of a kernel column
+double CSparseKernelMatrix::kernelColSum(int _j)
+{
+    double result = 0.0;
+
+    for (size_t k = m_K.rowStart[_j]; k < m_K.rowStart[_j+1]; ++k)
+        result += m_K.values[k];
+
+    return result;
+}
+
+
+// Dot product between two kernel columns (merge of their sorted nonzero values)
+double CSparseKernelMatrix::kernelColColDot(int _i, int _j)
+{
+    if (_i == _j)
+        return m_K.sqrNorm(_j);
+
+    double result = 0.0;
+    size_t k = m_K.rowStart[_i];
+    size_t l = m_K.rowStart[_j];
+
+    while (k < m_K.rowStart[_i+1] && l < m_K.rowStart[_j+1])
+    {
+        if (m_K.colIndex[k] < m_K.colIndex[l])
+            ++k;
+        else if (m_K.colIndex[k] > m_K.colIndex[l])
+            ++l;
+        else
+            result += m_K.values[k++] * m_K.values[l++];
+    }
+
+    return result;
+}
+
+
+// Add the product of the kernel columns by _w, with the exact kernel values (the ones below the
+// cutoff included): each column of nonzero weight is computed as the symmetric row
+void CSparseKernelMatrix::kernelMvProduct(gsl_vector* _ptrVector, gsl_vector* _w)
+{
+    gsl_matrix* row = gsl_matrix_alloc(1, nbEx);
+
+    for (int j = 0; j < nbEx; ++j)
+    {
+        double w_j = gsl_vector_get(_w, j);
+        if (w_j == 0.0)
+            continue;
+
+        m_kernel.fillKernelRows(m_data, j, 1, row);
+
+        gsl_vector_view col = gsl_matrix_row(row, 0);
+        MathUtils::add(_ptrVector, &col.vector, w_j);
+    }
+
+    gsl_matrix_free(row);
+}
@@ -0,0 +1,81 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+
+#ifndef SPARSE_KERNEL_MATRIX_H
+#define SPARSE_KERNEL_MATRIX_H
+
+#include "KernelMatrix.h"
+#include "Kernel.h"
+#include "SparseMatrix.h"
+
+#include <gsl/gsl_matrix.h>
+#include <gsl/gsl_vector.h>
+
+// Training RBF kernel matrix (train vs train, plus the bias column) where the kernel values
+// below a cutoff are set to 0. Only the pairs of examples within the corresponding radius,
+// ||x-y||^2 <= -ln(cutoff)/gamma, are evaluated (found with a k-d tree, see CKdTree) and stored,
+// in compressed sparse column form. The column operations used by the learners then cost
+// O(nonzeros of the column) instead of O(n). The classifier applies the exact kernel: the
+// matrix by vector product (its margins) computes the columns of nonzero weight exactly.
+class CSparseKernelMatrix : public CImplicitBiasKernelMatrix
+{
+public:
+    // Constructor / Destructor (the cycle of life!)
+    // _data   : training examples (features matrix and labels)
+    // _cutoff : smallest kernel value kept, in (0,1)
+    CSparseKernelMatrix(const CDataMatrix& _data, const CKernel& _kernel, double _cutoff);
+    virtual ~CSparseKernelMatrix()  { }
+
+    // Desallocate memory
+    virtual void        free();
+
+    // Number of nonzero values (without the bias column)
+    size_t              getNbNonZeros() const   { return m_K.getNbNonZeros(); }
+
+protected:
+    // Get a kernel column (scattered in one of two buffers)
+    virtual gsl_vector  getKernelCol(int _j);
+
+    // Operations on a kernel column, over its nonzero values only
+    virtual double      kernelColDot(int _j, gsl_vector* _v);
+    virtual void        kernelColAxpy(int _j, double _factor, gsl_vector* _v);
+    virtual double      kernelColSum(int _j);
+    virtual double      kernelColColDot(int _i, int _j);
+
+    // Product of the exact kernel columns by a vector
+    virtual void        kernelMvProduct(gsl_vector* _ptrVector, gsl_vector* _w);
+
+    // Find the kernel values above the cutoff: with a k-d tree (dense examples), or from
+    // the rows of the full matrix, one block at the time (sparse examples)
+    void                computeWithTree(const CDataMatrix& _data, int _nbThreads, double _gamma, double _sqrRadius);
+    void                computeByBlocks(const CDataMatrix& _data, const CKernel& _kernel, double _cutoff);
+
+    // Training examples and kernel function (for the exact columns)
+    CDataMatrix         m_data;
+    CKernel             m_kernel;
+
+    // Kernel matrix without the bias column (the matrix is symmetric: row j is column j)
+    CSparseMatrix       m_K;
+
+    // Buffers returned by getCol, and the column scattered in each of them (-1 if none)
+    gsl_matrix*         m_cols;
+    int                 m_colOfBuffer[2];
+    int                 m_nextCol;
+};
+
+#endif // SPARSE_KERNEL_MATRIX_H
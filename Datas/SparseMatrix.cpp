@@ -0,0 +1,99 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+#include "SparseMatrix.h"
+
+#include <cstring>
+
+
+// Constructor
+CSparseMatrix::CSparseMatrix()
+{
+    nbRows   = 0;
+    nbCols   = 0;
+    rowStart = NULL;
+    colIndex = NULL;
+    values   = NULL;
+    m_bOwner = false;
+}
+
+
+// Allocate memory (row starts set to 0)
+void CSparseMatrix::init(int _nbRows, int _nbCols, size_t _nbNonZeros)
+{
+    nbRows   = _nbRows;
+    nbCols   = _nbCols;
+    rowStart = new size_t[_nbRows+1];
+    colIndex = new int[_nbNonZeros];
+    values   = new double[_nbNonZeros];
+    m_bOwner = true;
+
+    memset(rowStart, 0, (_nbRows+1)*sizeof(size_t));
+}
+
+
+// Desallocate memory
+void CSparseMatrix::free()
+{
+    if (m_bOwner)
+    {
+        delete[] rowStart;
+        delete[] colIndex;
+        delete[] values;
+    }
+
+    nbRows   = 0;
+    nbCols   = 0;
+    rowStart = NULL;
+    colIndex = NULL;
+    values   = NULL;
+    m_bOwner = false;
+}
+
+
+// Make a new copy of this matrix (or view)
+CSparseMatrix* CSparseMatrix::duplicate() const
+{
+    CSparseMatrix* copy = new CSparseMatrix();
+    copy->init(nbRows, nbCols, getNbNonZeros());
+
+    size_t first = rowStart[0];
+
+    for (int i = 0; i <= nbRows; ++i)
+        copy->rowStart[i] = rowStart[i] - first;
+
+    memcpy(copy->colIndex, colIndex + first, getNbNonZeros()*sizeof(int));
+    memcpy(copy->values,   values + first,   getNbNonZeros()*sizeof(double));
+
+    return copy;
+}
+
+
+// View on consecutive rows (row starts remain offsets in the shared arrays)
+CSparseMatrix CSparseMatrix::rows(int _i0, int _nbRows) const
+{
+    CSparseMatrix view;
+
+    view.nbRows   = _nbRows;
+    view.nbCols   = nbCols;
+    view.rowStart = rowStart + _i0;
+    view.colIndex = colIndex;
+    view.values   = values;
+    view.m_bOwner = false;
+
+    return view;
+}
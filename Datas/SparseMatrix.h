@@ -0,0 +1,98 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+#ifndef SPARSE_MATRIX_H
+#define SPARSE_MATRIX_H
+
+#include <cstddef>
+
+// Sparse matrix in compressed sparse row format (CSR): the nonzero values of row i, and their
+// column indices, are at positions rowStart[i] to rowStart[i+1]-1 of 'values' / 'colIndex'.
+// A view on consecutive rows (see rows()) shares the arrays of the matrix it comes from.
+class CSparseMatrix
+{
+public:
+    // Matrix size and CSR arrays (declared 'public' for more commodity)
+    int         nbRows, nbCols;
+    size_t*     rowStart;   // nbRows+1 elements
+    int*        colIndex;   // nbNonZeros elements
+    double*     values;     // nbNonZeros elements
+
+public:
+    // Constructor / Destructor (the cycle of life!)
+    CSparseMatrix();
+    ~CSparseMatrix()    { }
+
+    // Allocate / Desallocate memory (a view does not own its memory)
+    void            init(int _nbRows, int _nbCols, size_t _nbNonZeros);
+    void            free();
+
+    // Make a new copy of this matrix
+    CSparseMatrix*  duplicate() const;
+
+    // View on rows [_i0, _i0+_nbRows) of this matrix
+    CSparseMatrix   rows(int _i0, int _nbRows) const;
+
+    // Number of nonzero values (of the whole matrix / of row i)
+    size_t          getNbNonZeros() const   { return rowStart[nbRows] - rowStart[0]; }
+    int             getRowSize(int _i) const { return rowStart[_i+1] - rowStart[_i]; }
+
+    // Operations on row i:   x_i * x_i,   x_i * v  (v dense, at least nbCols elements),
+    // v += x_i  (scatter),   v[nonzeros of x_i] = 0  (clear after scatter)
+    double          sqrNorm(int _i) const;
+    double          dot(int _i, const double* _v) const;
+    void            scatter(int _i, double* _v) const;
+    void            clear(int _i, double* _v) const;
+
+private:
+    bool            m_bOwner;
+};
+
+
+inline double CSparseMatrix::dot(int _i, const double* _v) const
+{
+    double result = 0.0;
+
+    for (size_t k = rowStart[_i]; k < rowStart[_i+1]; ++k)
+        result += values[k] * _v[ colIndex[k] ];
+
+    return result;
+}
+
+inline double CSparseMatrix::sqrNorm(int _i) const
+{
+    double result = 0.0;
+
+    for (size_t k = rowStart[_i]; k < rowStart[_i+1]; ++k)
+        result += values[k] * values[k];
+
+    return result;
+}
+
+inline void CSparseMatrix::scatter(int _i, double* _v) const
+{
+    for (size_t k = rowStart[_i]; k < rowStart[_i+1]; ++k)
+        _v[ colIndex[k] ] += values[k];
+}
+
+inline void CSparseMatrix::clear(int _i, double* _v) const
+{
+    for (size_t k = rowStart[_i]; k < rowStart[_i+1]; ++k)
+        _v[ colIndex[k] ] = 0.0;
+}
+
+#endif // SPARSE_MATRIX_H
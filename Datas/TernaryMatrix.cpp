@@ -0,0 +1,143 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+
+#include "TernaryMatrix.h"
+
+#include <cstring>
+
+
+// Constructor
+CTernaryMatrix::CTernaryMatrix()
+{
+    nbRows   = 0;
+    nbCols   = 0;
+    nbWords  = 0;
+    plus     = NULL;
+    minus    = NULL;
+    m_bOwner = false;
+}
+
+
+// True if all the values of a matrix are -1, 0 or +1
+bool CTernaryMatrix::isTernary(const gsl_matrix* _X)
+{
+    if (_X == NULL || _X->size1 == 0 || _X->size2 == 0)
+        return false;
+
+    for (size_t i = 0; i < _X->size1; ++i)
+    {
+        const double* row = gsl_matrix_const_ptr(_X, i, 0);
+
+        for (size_t j = 0; j < _X->size2; ++j)
+        {
+            if (row[j] != 0.0 && row[j] != 1.0 && row[j] != -1.0)
+                return false;
+        }
+    }
+
+    return true;
+}
+
+
+// Pack a matrix of ternary values
+CTernaryMatrix* CTernaryMatrix::pack(const gsl_matrix* _X)
+{
+    CTernaryMatrix* packed = new CTernaryMatrix();
+    packed->init(_X->size1, _X->size2);
+
+    for (int i = 0; i < packed->nbRows; ++i)
+    {
+        const double* row = gsl_matrix_const_ptr(_X, i, 0);
+        uint64_t*     p   = packed->plus  + (size_t)i*packed->nbWords;
+        uint64_t*     m   = packed->minus + (size_t)i*packed->nbWords;
+
+        for (int j = 0; j < packed->nbCols; ++j)
+        {
+            uint64_t bit = (uint64_t)1 << (j % 64);
+
+            if (row[j] > 0)
+                p[j / 64] |= bit;
+            else if (row[j] < 0)
+                m[j / 64] |= bit;
+        }
+    }
+
+    return packed;
+}
+
+
+// Allocate memory (all values set to 0)
+void CTernaryMatrix::init(int _nbRows, int _nbCols)
+{
+    nbRows   = _nbRows;
+    nbCols   = _nbCols;
+    nbWords  = (_nbCols + 63) / 64;
+    plus     = new uint64_t[(size_t)_nbRows*nbWords];
+    minus    = new uint64_t[(size_t)_nbRows*nbWords];
+    m_bOwner = true;
+
+    memset(plus,  0, (size_t)_nbRows*nbWords*sizeof(uint64_t));
+    memset(minus, 0, (size_t)_nbRows*nbWords*sizeof(uint64_t));
+}
+
+
+// Desallocate memory
+void CTernaryMatrix::free()
+{
+    if (m_bOwner)
+    {
+        delete[] plus;
+        delete[] minus;
+    }
+
+    nbRows   = 0;
+    nbCols   = 0;
+    nbWords  = 0;
+    plus     = NULL;
+    minus    = NULL;
+    m_bOwner = false;
+}
+
+
+// Make a new copy of this matrix (or view)
+CTernaryMatrix* CTernaryMatrix::duplicate() const
+{
+    CTernaryMatrix* copy = new CTernaryMatrix();
+    copy->init(nbRows, nbCols);
+
+    memcpy(copy->plus,  plus,  (size_t)nbRows*nbWords*sizeof(uint64_t));
+    memcpy(copy->minus, minus, (size_t)nbRows*nbWords*sizeof(uint64_t));
+
+    return copy;
+}
+
+
+// View on consecutive rows
+CTernaryMatrix CTernaryMatrix::rows(int _i0, int _nbRows) const
+{
+    CTernaryMatrix view;
+
+    view.nbRows   = _nbRows;
+    view.nbCols   = nbCols;
+    view.nbWords  = nbWords;
+    view.plus     = plus  + (size_t)_i0*nbWords;
+    view.minus    = minus + (size_t)_i0*nbWords;
+    view.m_bOwner = false;
+
+    return view;
+}
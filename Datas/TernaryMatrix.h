@@ -0,0 +1,115 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+
+#ifndef TERNARY_MATRIX_H
+#define TERNARY_MATRIX_H
+
+#include <gsl/gsl_matrix.h>
+#include <cstddef>
+#include <stdint.h>
+
+// Bit-packed matrix of ternary values (-1, 0 or +1), such as the features of survey datasets.
+// Each row is stored as two bitplanes of 64 bits words: 'plus' has the bits of the +1 values,
+// 'minus' those of the -1 values. The dot product of two rows and the squared norm of a row are
+// then computed with a few popcounts by word (64 features) instead of floating point operations.
+// A view on consecutive rows (see rows()) shares the bitplanes of the matrix it comes from.
+class CTernaryMatrix
+{
+public:
+    // Matrix size and bitplanes (declared 'public' for more commodity)
+    int         nbRows, nbCols;
+    int         nbWords;    // Words by row
+    uint64_t*   plus;       // nbRows*nbWords words
+    uint64_t*   minus;      // nbRows*nbWords words
+
+public:
+    // Constructor / Destructor (the cycle of life!)
+    CTernaryMatrix();
+    ~CTernaryMatrix()   { }
+
+    // True if all the values of a matrix are -1, 0 or +1
+    static bool             isTernary(const gsl_matrix* _X);
+
+    // Pack a matrix of ternary values (see isTernary)
+    static CTernaryMatrix*  pack(const gsl_matrix* _X);
+
+    // Allocate / Desallocate memory (a view does not own its memory)
+    void            init(int _nbRows, int _nbCols);
+    void            free();
+
+    // Make a new copy of this matrix
+    CTernaryMatrix* duplicate() const;
+
+    // View on rows [_i0, _i0+_nbRows) of this matrix
+    CTernaryMatrix  rows(int _i0, int _nbRows) const;
+
+    // Operations on row i:   x_i * x_i,   x_i * y_j  (y_j: row j of another matrix of nbCols columns)
+    double          sqrNorm(int _i) const;
+    double          dot(int _i, const CTernaryMatrix& _Y, int _j) const;
+
+private:
+    static int      popcount(uint64_t _w);
+
+    bool            m_bOwner;
+};
+
+
+inline int CTernaryMatrix::popcount(uint64_t _w)
+{
+#ifdef __GNUC__
+    return __builtin_popcountll(_w);
+#else
+    int count = 0;
+    for (; _w != 0; _w &= _w - 1)
+        ++count;
+    return count;
+#endif
+}
+
+inline double CTernaryMatrix::sqrNorm(int _i) const
+{
+    const uint64_t* p = plus  + (size_t)_i*nbWords;
+    const uint64_t* m = minus + (size_t)_i*nbWords;
+
+    int result = 0;
+    for (int w = 0; w < nbWords; ++w)
+        result += popcount(p[w] | m[w]);
+
+    return result;
+}
+
+// Nonzero products are +1 when the signs agree, -1 otherwise:
+// x*y = #(x!=0 and y!=0) - 2 #(signs differ)
+inline double CTernaryMatrix::dot(int _i, const CTernaryMatrix& _Y, int _j) const
+{
+    const uint64_t* p1 = plus     + (size_t)_i*nbWords;
+    const uint64_t* m1 = minus    + (size_t)_i*nbWords;
+    const uint64_t* p2 = _Y.plus  + (size_t)_j*nbWords;
+    const uint64_t* m2 = _Y.minus + (size_t)_j*nbWords;
+
+    int result = 0;
+    for (int w = 0; w < nbWords; ++w)
+    {
+        result += popcount( (p1[w] | m1[w]) & (p2[w] | m2[w]) );
+        result -= 2 * popcount( (p1[w] & m2[w]) | (m1[w] & p2[w]) );
+    }
+
+    return result;
+}
+
+#endif // TERNARY_MATRIX_H
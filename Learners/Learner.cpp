@@ -15,17 +15,30 @@
 
 
 #include "Learner.h"
+#include "Utils/MathUtils.h"
 
 using namespace std;
 
 // Constructor (default)
 CLearner::CLearner()
 {
+    data_train          = NULL;
+    m_pDenseTrain       = NULL;
     m_hasTestData       = false;
     m_pClassifier       = NULL;
 }
 
 
+// Desallocate memory
+void CLearner::free()
+{
+    if (m_pDenseTrain != NULL)
+        delete m_pDenseTrain;
+
+    m_pDenseTrain = NULL;
+}
+
+
 // Set algorithm parameters
 void CLearner::setParameters(const StrValueMap& _params)
 {
@@ -49,10 +62,59 @@ StrValueMap CLearner::getStats()
 }
 
 
-// Set training dataset
+// Set training dataset (a kernel matrix entirely stored in memory)
 void  CLearner::setTrainData(const CDataMatrix& _trainData)
 {
-    data_train = _trainData;
+    CLearner::free();
+
+    m_pDenseTrain = new CDenseKernelMatrix(_trainData);
+    data_train    = m_pDenseTrain;
+}
+
+
+// Set training dataset (the kernel matrix object is not owned by the learner)
+void  CLearner::setTrainData(CKernelMatrix* _pTrainData)
+{
+    CLearner::free();
+
+    data_train = _pTrainData;
+}
+
+
+// Proportion of training examples whose margin has not the sign of the label
+double CLearner::calcTrainRisk(gsl_vector* _vMargins)
+{
+    if (data_train->nbEx == 0)
+        return 0.0;
+
+    double nbErrors = 0;
+    for (int i = 0; i < data_train->nbEx; ++i)
+    {
+        if ( (gsl_vector_get(data_train->Y, i)>0.0) != (gsl_vector_get(_vMargins, i)>0.0) )
+            nbErrors += colWeight(i);
+    }
+
+    return nbErrors/totalWeight();
+}
+
+
+// Weight of a column of the train matrix (1 for the bias column)
+double CLearner::colWeight(int _j) const
+{
+    if (data_train->W == NULL || _j >= data_train->nbEx)
+        return 1.0;
+
+    return gsl_vector_get(data_train->W, _j);
+}
+
+
+// Total weight of the training examples
+double CLearner::totalWeight() const
+{
+    if (data_train->W == NULL)
+        return data_train->nbEx;
+
+    return MathUtils::sum(data_train->W);
 }
 
 
@@ -18,6 +18,7 @@
 #define LEARNER_H
 
 #include "Datas/DataMatrix.h"
+#include "Datas/KernelMatrix.h"
 #include "Classifiers/Classifier.h"
 #include "Utils/StrValue.h"
 
@@ -30,13 +31,15 @@ public:
 
     // Allocate / Desallocate memory
     virtual void            init()  { }
-    virtual void            free()  { }
+    virtual void            free();
 
     // Set algorithm parameters
     virtual void            setParameters(const StrValueMap& _params);
 
     // Set training (required) / testing (optional) datasets
+    // The training kernel matrix can be given in any representation (see CKernelMatrix)
     void                    setTrainData(const CDataMatrix& _trainData);
+    void                    setTrainData(CKernelMatrix* _pTrainData);
     void                    setTestData(const CDataMatrix& _testData);
 
     // Execute learning algorithm
@@ -53,16 +56,28 @@ protected:
     template <class T>
     void setParam(const StrValueMap& _map, const char* _key, T& _var, const T& _default);
 
+    // Proportion of training examples whose margin (classifier output) has not the sign of the label
+    // (each example counts as many times as its weight)
+    double              calcTrainRisk(gsl_vector* _vMargins);
+
+    // Weight of a column of the train matrix: multiplicity of its example (see CKernelMatrix::W),
+    // 1 for the bias column. Total weight of the training examples (their number before merging).
+    double              colWeight(int _j) const;
+    double              totalWeight() const;
+
     // Algorithm parametes
     bool                param_bVerbose;  // display more output
     bool                param_bWriteLog; // write a log file?
     std::string         param_sLogFile;  // log file name
 
     // Training / Testing sets
-    CDataMatrix         data_train;
+    CKernelMatrix*      data_train;
     CDataMatrix         data_test;
     bool                m_hasTestData;
 
+    // Training kernel matrix wrapper allocated by setTrainData(const CDataMatrix&), if any
+    CDenseKernelMatrix* m_pDenseTrain;
+
     // Classifier produced after learning
     CClassifier*        m_pClassifier;
 };
@@ -53,6 +53,7 @@ StrValueMap CPbscAlignLearner::getStats()
     stats["nIter"] = m_iter;
     stats["cost"]  = m_cost;
     stats["saturation"] = m_saturation;
+    stats["Train Risk"] = m_trainRisk;
     stats["q"]     = param_q;
     stats["seed"]  = param_seed;
 
@@ -84,31 +85,32 @@ void CPbscAlignLearner::free()
 // Execute learning algorithm
 CClassifier* CPbscAlignLearner::learn()
 {
-    m_pClassifier = new CLinearClassifier(data_train.nbFt);
+    m_pClassifier = new CLinearClassifier(data_train->nbFt);
     m_pClassifier->init();
 
-    // Weight vector
-    m_vWeights = gsl_vector_calloc(data_train.nbFt);
-    double saturationValue = 1.0/(data_train.nbFt);
+    // Weight vector. The weight of a merged example is bounded by the sum of the bounds of
+    // its occurrences (see colWeight)
+    m_vWeights = gsl_vector_calloc(data_train->nbFt);
+    double saturationValue = 1.0/(totalWeight()+1);
     gsl_vector_set_all(m_vWeights, 0.0);
 
     // Distribution on examples
-    m_vDist = gsl_vector_alloc(data_train.nbEx);
-    MathUtils::mvProduct(m_vDist, data_train.X, m_vWeights, false);
-    MathUtils::add(m_vDist, data_train.Y, -param_q);
+    m_vDist = gsl_vector_alloc(data_train->nbEx);
+    data_train->mvProduct(m_vDist, m_vWeights);
+    MathUtils::add(m_vDist, data_train->Y, -param_q);
+    data_train->trackVector(m_vDist);
    
     // For each column of the kernel matrix, we compute the sum of its squarred elements
     // (This constant will by used during the minimization procedure)
-    m_vColSquared = gsl_vector_alloc(data_train.nbFt);
-    for (int i = 0; i < data_train.nbFt; ++i)
+    m_vColSquared = gsl_vector_alloc(data_train->nbFt);
+    for (int i = 0; i < data_train->nbFt; ++i)
     {
-        gsl_vector v = data_train.getCol(i);
-        gsl_vector_set(m_vColSquared, i, MathUtils::dot(&v, &v));
+        gsl_vector_set(m_vColSquared, i, data_train->colSqrNorm(i));
     }
 
     // Visit order (shuffled before each iteration)
-    vector<int> visitOrder(data_train.nbFt);
-    for (int i = 0; i < data_train.nbFt; ++i)
+    vector<int> visitOrder(data_train->nbFt);
+    for (int i = 0; i < data_train->nbFt; ++i)
         visitOrder[i] = i;
 
     m_saturation    = 0.0;
@@ -117,7 +119,7 @@ CClassifier* CPbscAlignLearner::learn()
         initLog();
 
     // Minimization procedure
-    double          weight, delta;
+    double          weight, delta, bound;
     int             wIndex;
     bool            bContinue;
     int             barStep;
@@ -141,24 +143,26 @@ CClassifier* CPbscAlignLearner::learn()
         // Visit each component of the weight vector
         m_maxDelta   = 0.0;
         m_saturation = 0.0;
-        for (int i = 0; i < data_train.nbFt; ++i)
+        for (int i = 0; i < data_train->nbFt; ++i)
         {
-            // Select the component to minimize
+            // Select the component to minimize (the next ones are read ahead)
             wIndex = visitOrder[i];
+            data_train->readAhead(visitOrder, i);
             weight = gsl_vector_get(m_vWeights, wIndex);
+            bound  = saturationValue * colWeight(wIndex);
              
             // Compute weight transfer
             delta = findDelta(wIndex);
             
-            if (weight+delta >= saturationValue)
+            if (weight+delta >= bound)
             {
-                delta         = saturationValue-weight;
-                m_saturation += saturationValue;
+                delta         = bound-weight;
+                m_saturation += bound;
             }
-            else if (weight+delta <= -saturationValue)
+            else if (weight+delta <= -bound)
             {
-                delta         = -saturationValue-weight;
-                m_saturation += saturationValue;
+                delta         = -bound-weight;
+                m_saturation += bound;
             }
 
             // Updating weight vector
@@ -166,8 +170,7 @@ CClassifier* CPbscAlignLearner::learn()
             m_maxDelta = max(m_maxDelta, fabs(delta));
             
             // Updating distribution on examples
-            gsl_vector v = data_train.getCol(wIndex);
-            MathUtils::add(m_vDist, &v, delta);
+            data_train->colAxpy(wIndex, delta, m_vDist);
         }
 
         // Stoping criteria
@@ -180,7 +183,7 @@ CClassifier* CPbscAlignLearner::learn()
     // Writting log file, if necessary
     if (param_bWriteLog)
     {
-        writeLog();
+        writeLog(true);
         finalizeLog();
     }
     else
@@ -190,9 +193,17 @@ CClassifier* CPbscAlignLearner::learn()
 
     ((CLinearClassifier*)m_pClassifier)->setWeights(m_vWeights);
 
+    // Training risk, from the margins of the final classifier
+    gsl_vector* vMargins = gsl_vector_alloc(data_train->nbEx);
+    calcMargins(vMargins, true);
+    m_trainRisk = calcTrainRisk(vMargins);
+    gsl_vector_free(vMargins);
+
     // Freeing memory
+    data_train->trackVector(NULL);
     gsl_vector_free(m_vWeights);
     gsl_vector_free(m_vDist);
+    gsl_vector_free(m_vColSquared);
 
     return m_pClassifier;
 }
@@ -201,29 +212,43 @@ CClassifier* CPbscAlignLearner::learn()
 // Compute the optimal weight transfer for a component of the weight vector
 double CPbscAlignLearner::findDelta(int _wIndex)
 {
-    gsl_vector v = data_train.getCol(_wIndex);
-    double dot = MathUtils::dot(m_vDist, &v);
+    double dot = data_train->colDot(_wIndex, m_vDist);
     double sqr = gsl_vector_get(m_vColSquared, _wIndex);
 
     return -dot/sqr;
 }
 
 
+// Compute the classifier output on each training example, ie: K * weights.
+// As the distribution on examples is K * weights - q * labels, it is obtained in O(n). But adding
+// back q * labels cancels the margins close to zero (and the distribution drifts along the
+// updates), so the exact margins are computed by a matrix by vector product.
+void CPbscAlignLearner::calcMargins(gsl_vector* _vMargins, bool _bExact /*= false*/)
+{
+    data_train->flushTrackedVector();
+
+    if (_bExact)
+        data_train->mvProduct(_vMargins, m_vWeights);
+    else
+        MathUtils::add(_vMargins, m_vDist, data_train->Y, param_q);
+}
+
+
 // Compute objective function cost value
 double CPbscAlignLearner::calcCost()
 {
-    gsl_vector* vMargins = gsl_vector_alloc(data_train.nbEx);
+    gsl_vector* vMargins = gsl_vector_alloc(data_train->nbEx);
 
-    MathUtils::mvProduct(vMargins, data_train.X, m_vWeights, false);
-    MathUtils::multiply(vMargins, data_train.Y);
+    calcMargins(vMargins);
+    MathUtils::multiply(vMargins, data_train->Y);
 
     double loss = 0.0;
     double tmp;
 
-    for (int i = 0; i < data_train.nbEx; ++i)
+    for (int i = 0; i < data_train->nbEx; ++i)
     {
         tmp  =  param_q - gsl_vector_get(vMargins, i);
-        loss += tmp*tmp;
+        loss += colWeight(i) * tmp*tmp;
     }
     
     gsl_vector_free(vMargins);
@@ -259,7 +284,7 @@ void CPbscAlignLearner::finalizeLog()
 
 
 // Write a line in the log file
-void CPbscAlignLearner::writeLog()
+void CPbscAlignLearner::writeLog(bool _bFinal /*= false*/)
 {
     StrValueMap map;
 
@@ -272,7 +297,10 @@ void CPbscAlignLearner::writeLog()
     map["maxDelta"]     = m_maxDelta;
     map["Saturation"]   = m_saturation;
 
-    map["TrainRisk"]    = m_pClassifier->calcRisk(data_train);
+    gsl_vector* vMargins = gsl_vector_alloc(data_train->nbEx);
+    calcMargins(vMargins, _bFinal);
+    map["TrainRisk"]    = calcTrainRisk(vMargins);
+    gsl_vector_free(vMargins);
 
     if (m_hasTestData)
     {
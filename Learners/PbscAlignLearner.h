@@ -45,12 +45,16 @@ protected:
     // Compute the optimal weight transfer for a component of the weight vector
     double      findDelta(int _wIndex);
 
+    // Compute the classifier output on each training example: in O(n) from the distribution on
+    // examples during the sweeps, or exactly from the weights (_bExact, for the final values)
+    void        calcMargins(gsl_vector* _vMargins, bool _bExact = false);
+
     // Compute objective function cost value
     double      calcCost();
 
     // Log file helpers
     void        initLog();
-    void        writeLog();
+    void        writeLog(bool _bFinal = false);
     void        finalizeLog();
 
     // Algorithm parameters
@@ -84,6 +88,9 @@ protected:
     // Maximum weight exchange during an iteration
     double      m_maxDelta;
 
+    // Training risk of the learned classifier
+    double      m_trainRisk;
+
     // Random number generator
     gsl_rng*    m_randomNumberGen;
     
@@ -57,6 +57,7 @@ StrValueMap CPbscNonAlignLearner::getStats()
 
     stats["nIter"] = m_iter;
     stats["cost"]  = m_cost;
+    stats["Train Risk"] = m_trainRisk;
     stats["C"]     = param_C;
     stats["q"]     = param_q;
     stats["seed"]  = param_seed;
@@ -89,24 +90,39 @@ void CPbscNonAlignLearner::free()
 // Execute learning algorithm
 CClassifier* CPbscNonAlignLearner::learn()
 {
-    m_pClassifier = new CLinearClassifier(data_train.nbFt);
+    m_pClassifier = new CLinearClassifier(data_train->nbFt);
     m_pClassifier->init();
 
-    // Weight vector
-    m_vWeights = gsl_vector_alloc(2*data_train.nbFt);
-    gsl_vector_set_all(m_vWeights, 1.0/(2*data_train.nbFt) );
+    // Weight vector, initialized to the prior: uniform on the examples before merging, so that
+    // a merged example has the prior of all its occurrences (see colWeight)
+    m_vWeights = gsl_vector_alloc(2*data_train->nbFt);
+    double priorValue = 1.0/(2*(totalWeight()+1));
+    for (int i = 0; i < data_train->nbFt; ++i)
+    {
+        gsl_vector_set(m_vWeights, i,                    priorValue * colWeight(i));
+        gsl_vector_set(m_vWeights, i + data_train->nbFt, priorValue * colWeight(i));
+    }
 
-    m_vGroupWeights = gsl_vector_alloc(data_train.nbFt);
+    m_vGroupWeights = gsl_vector_alloc(data_train->nbFt);
     groupWeights();
 
     // Distribution on examples
-    m_vDist = gsl_vector_alloc(data_train.nbEx);
-    MathUtils::mvProduct(m_vDist, data_train.X, m_vGroupWeights, false);
-    MathUtils::add(m_vDist, data_train.Y, -param_q);
+    m_vDist = gsl_vector_alloc(data_train->nbEx);
+    data_train->mvProduct(m_vDist, m_vGroupWeights);
+    MathUtils::add(m_vDist, data_train->Y, -param_q);
+    data_train->trackVector(m_vDist);
+
+    // For each column of the kernel matrix, we compute the sum of its squarred elements
+    // (This constant will by used during the minimization procedure)
+    m_vColSquared = gsl_vector_alloc(data_train->nbFt);
+    for (int i = 0; i < data_train->nbFt; ++i)
+    {
+        gsl_vector_set(m_vColSquared, i, data_train->colSqrNorm(i));
+    }
    
     // Visit order (shuffled before each iteration)
-    vector<int> visitOrder1(2*data_train.nbFt);
-    for (int i = 0; i < 2*data_train.nbFt; ++i)
+    vector<int> visitOrder1(2*data_train->nbFt);
+    for (int i = 0; i < 2*data_train->nbFt; ++i)
         visitOrder1[i] = i;
 
     m_maxDelta      = 0.0;
@@ -138,14 +154,15 @@ CClassifier* CPbscNonAlignLearner::learn()
         MathUtils::shuffleVector(visitOrder1, m_randomNumberGen);
 
         // Visit each component of the weight vector
-        for (int i = 0; i < 2*data_train.nbFt; ++i)
+        for (int i = 0; i < 2*data_train->nbFt; ++i)
         {
-            // Select the component to minimize
+            // Select the component to minimize (the next ones are read ahead)
             index1  = visitOrder1[i];
+            data_train->readAhead(visitOrder1, i);
             weight1 = gsl_vector_get(m_vWeights, index1);
 
             do{
-                index2  = gsl_rng_uniform_int(m_randomNumberGen, 2*data_train.nbFt);
+                index2  = gsl_rng_uniform_int(m_randomNumberGen, 2*data_train->nbFt);
                 weight2 = gsl_vector_get(m_vWeights, index2);
             } while( index1 == index2 || 2*EPS_BRENT >= weight1+weight2 );
 
@@ -171,10 +188,8 @@ CClassifier* CPbscNonAlignLearner::learn()
             m_maxDelta = max(m_maxDelta, fabs(delta));
             
             // Updating distribution on examples
-            gsl_vector g1 = data_train.getCol(index1 - ( index1 < data_train.nbFt ? 0 : data_train.nbFt ) );
-            gsl_vector g2 = data_train.getCol(index2 - ( index2 < data_train.nbFt ? 0 : data_train.nbFt ) ) ;
-            MathUtils::add( m_vDist, &g1, +delta * ( index1 < data_train.nbFt ? +1 : -1 ) );
-            MathUtils::add( m_vDist, &g2, -delta * ( index2 < data_train.nbFt ? +1 : -1 ) );
+            data_train->colAxpy( index1 - ( index1 < data_train->nbFt ? 0 : data_train->nbFt ), +delta * ( index1 < data_train->nbFt ? +1 : -1 ), m_vDist );
+            data_train->colAxpy( index2 - ( index2 < data_train->nbFt ? 0 : data_train->nbFt ), -delta * ( index2 < data_train->nbFt ? +1 : -1 ), m_vDist );
 
             if (param_bVerbose)
             {
@@ -203,7 +218,7 @@ CClassifier* CPbscNonAlignLearner::learn()
     // Writting log file, if necessary
     if (param_bWriteLog)
     {
-        writeLog();
+        writeLog(true);
         finalizeLog();
     }
     else
@@ -215,10 +230,18 @@ CClassifier* CPbscNonAlignLearner::learn()
     groupWeights();
     ((CLinearClassifier*)m_pClassifier)->setWeights(m_vGroupWeights);
 
+    // Training risk, from the margins of the final classifier
+    gsl_vector* vMargins = gsl_vector_alloc(data_train->nbEx);
+    calcMargins(vMargins, true);
+    m_trainRisk = calcTrainRisk(vMargins);
+    gsl_vector_free(vMargins);
+
     // Freeing memory
+    data_train->trackVector(NULL);
     gsl_vector_free(m_vWeights);
     gsl_vector_free(m_vGroupWeights);
     gsl_vector_free(m_vDist);
+    gsl_vector_free(m_vColSquared);
 
     return m_pClassifier;
 }
@@ -237,21 +260,21 @@ double CPbscNonAlignLearner::findDelta(int _index1, int _index2)
         return 0.0;
     }
 
-    // Compute constant values appearing in the function F(delta)
-    gsl_vector *v = gsl_vector_calloc(data_train.nbEx);
-
-    gsl_vector g1 = data_train.getCol( _index1 - ( _index1 < data_train.nbFt ? 0 : data_train.nbFt ) );
-    gsl_vector g2 = data_train.getCol( _index2 - ( _index2 < data_train.nbFt ? 0 : data_train.nbFt ));
-    MathUtils::add( v, &g1, (_index1 < data_train.nbFt ? +1 : -1), &g2, -1*(_index2 < data_train.nbFt ? +1 : -1) );
+    // Compute constant values appearing in the function F(delta), from the columns
+    // g1 and g2 of the kernel matrix: v = s1*g1 - s2*g2, dot = v*dist, sqr = v*v
+    int    col1  = _index1 - ( _index1 < data_train->nbFt ? 0 : data_train->nbFt );
+    int    col2  = _index2 - ( _index2 < data_train->nbFt ? 0 : data_train->nbFt );
+    double sign1 = (_index1 < data_train->nbFt ? +1 : -1);
+    double sign2 = (_index2 < data_train->nbFt ? +1 : -1);
 
-    double dot = MathUtils::dot(m_vDist, v);
-    double sqr = MathUtils::dot(v,v);
+    double dot = sign1 * data_train->colDot(col1, m_vDist) - sign2 * data_train->colDot(col2, m_vDist);
+    double sqr = gsl_vector_get(m_vColSquared, col1) + gsl_vector_get(m_vColSquared, col2)
+                 - 2 * sign1 * sign2 * data_train->colColDot(col1, col2);
 
-    gsl_vector_free(v);
+    double mult  = 0.5 * totalWeight() * param_q*param_q/param_C;
+    double prior = log( colWeight(col1) / colWeight(col2) );
 
-    double mult = 0.5 * data_train.nbEx * param_q*param_q/param_C;
-
-    ParamsDelta fctparams = { mult, dot, sqr, w1, w2 };
+    ParamsDelta fctparams = { mult, dot, sqr, w1, w2, prior };
 
     // Compute the values of F(delta) at the limit of the possible interval
     double valInf = fctDelta(-w1+EPS_BRENT, &fctparams);
@@ -308,50 +331,69 @@ double CPbscNonAlignLearner::fctDelta(double x, void *_params)
 {
     ParamsDelta* P = (ParamsDelta*)_params;
 
-    return P->mult * log( (P->w2 - x) / (P->w1 + x))
+    return P->mult * (log( (P->w2 - x) / (P->w1 + x)) + P->prior)
              - x*P->sqr - P->dot;
 }
 
 
+// Compute the classifier output on each training example, ie: K * grouped weights.
+// As the distribution on examples is K * grouped weights - q * labels, it is obtained in O(n).
+// But adding back q * labels cancels the margins close to zero (and the distribution drifts
+// along the updates), so the exact margins are computed by a matrix by vector product.
+void CPbscNonAlignLearner::calcMargins(gsl_vector* _vMargins, bool _bExact /*= false*/)
+{
+    data_train->flushTrackedVector();
+
+    if (_bExact)
+    {
+        groupWeights();
+        data_train->mvProduct(_vMargins, m_vGroupWeights);
+    }
+    else
+        MathUtils::add(_vMargins, m_vDist, data_train->Y, param_q);
+}
+
+
 // Compute objective function cost value
 double CPbscNonAlignLearner::calcCost(double* _ptrKL /*= NULL*/)
 {
     groupWeights();
 
-    gsl_vector* vMargins = gsl_vector_alloc(data_train.nbEx);
-    MathUtils::mvProduct(vMargins, data_train.X, m_vGroupWeights, false);
-    MathUtils::multiply(vMargins, data_train.Y);
+    gsl_vector* vMargins = gsl_vector_alloc(data_train->nbEx);
+    calcMargins(vMargins);
+    MathUtils::multiply(vMargins, data_train->Y);
 
     double loss = 0.0;
     double tmp;
 
-    for (int i = 0; i < data_train.nbEx; ++i)
+    for (int i = 0; i < data_train->nbEx; ++i)
     {
         tmp  =  1.0 - gsl_vector_get(vMargins, i) / param_q;
-        loss += tmp*tmp;
+        loss += colWeight(i) * tmp*tmp;
     }
     
     gsl_vector_free(vMargins);
 
-    double KL = log(2*data_train.nbFt);
+    // KL divergence with the prior (the weights of merged examples have a larger prior)
+    double KL = log(2*(totalWeight()+1));
     double w_i;
 
-    for (int i = 0; i < 2*data_train.nbFt; ++i)
+    for (int i = 0; i < 2*data_train->nbFt; ++i)
     {
         w_i = gsl_vector_get(m_vWeights, i);
         if (w_i > 0)
-            KL += w_i * log(w_i);
+            KL += w_i * log(w_i / colWeight(i % data_train->nbFt));
     }
 
-    return param_C * loss + data_train.nbEx * KL;
+    return param_C * loss + totalWeight() * KL;
 }
 
 
 // Regroup complementary weights (vector of size 2*m) in a regular weight vector (of size m)
 void CPbscNonAlignLearner::groupWeights()
 {
-    gsl_vector_view vFirstPart  = gsl_vector_subvector(m_vWeights, 0, data_train.nbFt);
-    gsl_vector_view vSecondPart = gsl_vector_subvector(m_vWeights, data_train.nbFt, data_train.nbFt);
+    gsl_vector_view vFirstPart  = gsl_vector_subvector(m_vWeights, 0, data_train->nbFt);
+    gsl_vector_view vSecondPart = gsl_vector_subvector(m_vWeights, data_train->nbFt, data_train->nbFt);
 
     MathUtils::substract(m_vGroupWeights, &vFirstPart.vector, &vSecondPart.vector);
 }
@@ -384,7 +426,7 @@ void CPbscNonAlignLearner::finalizeLog()
 
 
 // Write a line in the log file
-void CPbscNonAlignLearner::writeLog()
+void CPbscNonAlignLearner::writeLog(bool _bFinal /*= false*/)
 {
     StrValueMap map;
 
@@ -398,7 +440,10 @@ void CPbscNonAlignLearner::writeLog()
     map["maxDelta"]     = m_maxDelta;
     map["maxBrent"]     = m_maxBrent;
 
-    map["TrainRisk"]    = m_pClassifier->calcRisk(data_train);
+    gsl_vector* vMargins = gsl_vector_alloc(data_train->nbEx);
+    calcMargins(vMargins, _bFinal);
+    map["TrainRisk"]    = calcTrainRisk(vMargins);
+    gsl_vector_free(vMargins);
 
     if (m_hasTestData)
     {
@@ -46,7 +46,11 @@ protected:
 
     static double   fctDelta(double x, void *_params);
 
-    struct          ParamsDelta { double  mult, dot, sqr, w1, w2; };
+    struct          ParamsDelta { double  mult, dot, sqr, w1, w2, prior; };
+
+    // Compute the classifier output on each training example: in O(n) from the distribution on
+    // examples during the sweeps, or exactly from the weights (_bExact, for the final values)
+    void            calcMargins(gsl_vector* _vMargins, bool _bExact = false);
 
     // Compute objective function cost value
     double          calcCost(double* _ptrKL = NULL);
@@ -56,7 +60,7 @@ protected:
 
     // Log file helpers
     void        initLog();
-    void        writeLog();
+    void        writeLog(bool _bFinal = false);
     void        finalizeLog();
 
     // Algorithm parameters
@@ -74,6 +78,9 @@ protected:
     // Distribution of weights over examples
     gsl_vector* m_vDist;
 
+    // Sum of the squared elements on each kernel matrix columns
+    gsl_vector* m_vColSquared;
+
     // Log file
     CTabLogFile m_log;
 
@@ -92,6 +99,9 @@ protected:
     // Maximum number of iteration performed by Brent root-finding method
     int         m_maxBrent;
 
+    // Training risk of the learned classifier
+    double      m_trainRisk;
+
     // Random number generator
     gsl_rng*    m_randomNumberGen;
     
@@ -0,0 +1,284 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+
+#include "Allocator.h"
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <stdexcept>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace std;
+
+// NUMA policy of mbind (see <numaif.h>, which comes with libnuma)
+#ifndef MPOL_INTERLEAVE
+#define MPOL_INTERLEAVE 3
+#endif
+
+// Huge pages size when the system does not tell it
+#define DEFAULT_HUGE_PAGE_SIZE (2*1024*1024)
+
+
+// Constructor
+CAllocator::CAllocator()
+{
+    m_hugePages   = HUGEPAGES_NONE;
+    m_numa        = NUMA_NONE;
+    m_nbThreads   = 1;
+    m_largestSize = 0;
+    m_placement   = "default (no matrix larger than a huge page)";
+}
+
+
+// Known parameters values
+bool CAllocator::isHugePagesMode(const string& _hugePages)
+{
+    return _hugePages == "0" || _hugePages == "none" || _hugePages == "transparent" || _hugePages == "explicit";
+}
+
+bool CAllocator::isNumaPlacement(const string& _numa)
+{
+    return _numa == "0" || _numa == "none" || _numa == "interleave" || _numa == "partition";
+}
+
+
+// Constructor from the parameters values: huge pages '0' (none), 'transparent' or 'explicit';
+// NUMA '0' (none), 'interleave' or 'partition'; number of threads touching the pages (0 = one
+// per processor). The mains reject the unknown values first (see isHugePagesMode, isNumaPlacement)
+CAllocator::CAllocator(const string& _hugePages, const string& _numa, int _nbThreads /*= 1*/)
+{
+    if (_hugePages == "0" || _hugePages == "none")
+        m_hugePages = HUGEPAGES_NONE;
+    else if (_hugePages == "transparent")
+        m_hugePages = HUGEPAGES_TRANSPARENT;
+    else if (_hugePages == "explicit")
+        m_hugePages = HUGEPAGES_EXPLICIT;
+    else
+        throw logic_error("[CAllocator::CAllocator] Unknown huge pages mode '" + _hugePages + "'.");
+
+    if (_numa == "0" || _numa == "none")
+        m_numa = NUMA_NONE;
+    else if (_numa == "interleave")
+        m_numa = NUMA_INTERLEAVE;
+    else if (_numa == "partition")
+        m_numa = NUMA_PARTITION;
+    else
+        throw logic_error("[CAllocator::CAllocator] Unknown NUMA placement '" + _numa + "'.");
+
+#ifdef _OPENMP
+    m_nbThreads = (_nbThreads > 0) ? _nbThreads : omp_get_num_procs();
+#else
+    m_nbThreads = 1;
+#endif
+
+    m_largestSize = 0;
+    m_placement   = "default (no matrix larger than a huge page)";
+}
+
+
+// Allocator used by the datasets
+CAllocator& CAllocator::getDefault()
+{
+    static CAllocator allocator;
+    return allocator;
+}
+
+
+// Size of the huge pages ("Hugepagesize" line of /proc/meminfo, in kB)
+size_t CAllocator::getHugePageSize()
+{
+    ifstream file("/proc/meminfo");
+    string line;
+
+    while ( getline(file, line) )
+    {
+        size_t kB;
+        if (line.compare(0, 13, "Hugepagesize:") == 0 && istringstream(line.substr(13)) >> kB)
+            return kB * 1024;
+    }
+
+    return DEFAULT_HUGE_PAGE_SIZE;
+}
+
+
+// Online NUMA nodes, from the list of /sys/devices/system/node/online (ie: "0-1,3")
+static vector<int> getOnlineNodes()
+{
+    vector<int> nodes;
+
+    ifstream file("/sys/devices/system/node/online");
+    string range;
+
+    while ( getline(file, range, ',') )
+    {
+        int first, last;
+        char dash;
+        istringstream in(range);
+
+        if ( !(in >> first) )
+            continue;
+        if ( !(in >> dash >> last) )
+            last = first;
+
+        for (int node = first; node <= last; ++node)
+            nodes.push_back(node);
+    }
+
+    if ( nodes.empty() )
+        nodes.push_back(0);
+
+    return nodes;
+}
+
+
+// Number of NUMA nodes
+int CAllocator::getNbNodes()
+{
+    return getOnlineNodes().size();
+}
+
+
+// True if the system may back the memory by transparent huge pages
+static bool transparentHugePagesEnabled()
+{
+    ifstream file("/sys/kernel/mm/transparent_hugepage/enabled");
+    string modes;
+
+    return getline(file, modes) && modes.find("[never]") == string::npos;
+}
+
+
+// Allocate a block of memory
+CMappedFile* CAllocator::allocate(size_t _nbRows, size_t _rowSize)
+{
+    size_t size          = _nbRows * _rowSize;
+    size_t hugePageSize  = getHugePageSize();
+    size_t pageSize      = sysconf(_SC_PAGESIZE);
+
+    if ( isDefault() || size < hugePageSize )
+        return NULL;
+
+    CMappedFile* pBlock = new CMappedFile();
+    ostringstream placement;
+
+    // Explicit huge pages: the block is rounded to a whole number of pages
+    if ( m_hugePages == HUGEPAGES_EXPLICIT
+         && pBlock->allocate((size + hugePageSize-1) / hugePageSize * hugePageSize, true) )
+    {
+        pageSize = hugePageSize;
+        placement << "explicit huge pages of " << hugePageSize/1024 << " KB";
+    }
+    else
+    {
+        // The default allocation reports the lack of memory, if any
+        if ( !pBlock->allocate(size) )
+        {
+            delete pBlock;
+            return NULL;
+        }
+
+        if ( m_hugePages != HUGEPAGES_NONE && transparentHugePagesEnabled()
+             && madvise(pBlock->data(), size, MADV_HUGEPAGE) == 0 )
+        {
+            pageSize = hugePageSize;
+            placement << "transparent huge pages of " << hugePageSize/1024 << " KB";
+        }
+        else
+        {
+            placement << "pages of " << pageSize/1024 << " KB";
+        }
+
+        if (m_hugePages == HUGEPAGES_EXPLICIT && pageSize != hugePageSize)
+            placement << " (no huge pages available)";
+        else if (m_hugePages == HUGEPAGES_EXPLICIT)
+            placement << " (not enough explicit huge pages)";
+        else if (m_hugePages == HUGEPAGES_TRANSPARENT && pageSize != hugePageSize)
+            placement << " (transparent huge pages disabled)";
+    }
+
+    // NUMA placement, before any page is touched
+    int nbNodes = getNbNodes();
+
+    if (m_numa == NUMA_INTERLEAVE)
+    {
+        if ( interleave(pBlock->data(), pBlock->size()) )
+            placement << ", interleaved over " << nbNodes << " NUMA node(s)";
+        else
+            placement << ", not interleaved (refused by the system)";
+    }
+    else if (m_numa == NUMA_PARTITION)
+    {
+        partition((char*)pBlock->data(), _nbRows, _rowSize, pageSize);
+        placement << ", partitioned among " << m_nbThreads << " thread(s) over " << nbNodes << " NUMA node(s)";
+    }
+
+    // Blocks may be allocated by several threads (see CDataPipeline)
+    #pragma omp critical(allocator_placement)
+    {
+        if (size > m_largestSize)
+        {
+            m_largestSize = size;
+            m_placement   = placement.str();
+        }
+    }
+
+    return pBlock;
+}
+
+
+// Interleave the pages of a block over all the nodes
+bool CAllocator::interleave(void* _data, size_t _size) const
+{
+#ifdef SYS_mbind
+    const int BITS = 8 * sizeof(unsigned long);
+
+    vector<int> nodes = getOnlineNodes();
+    vector<unsigned long> mask(nodes.back() / BITS + 1, 0);
+
+    for (size_t k = 0; k < nodes.size(); ++k)
+        mask[ nodes[k] / BITS ] |= 1UL << (nodes[k] % BITS);
+
+    // The system reads one bit less than 'maxnode'
+    return syscall(SYS_mbind, _data, _size, MPOL_INTERLEAVE, &mask[0], mask.size()*BITS + 1, 0) == 0;
+#else
+    return false;
+#endif
+}
+
+
+// Touch the first byte of each page: the rows are split among the threads as by a static
+// schedule, and each page goes to the thread owning the row where it begins
+void CAllocator::partition(char* _data, size_t _nbRows, size_t _rowSize, size_t _pageSize) const
+{
+    #pragma omp parallel for schedule(static) num_threads(m_nbThreads)
+    for (long i = 0; i < (long)_nbRows; ++i)
+    {
+        size_t begin = i * _rowSize;
+        size_t end   = begin + _rowSize;
+
+        for (size_t offset = (begin + _pageSize-1) / _pageSize * _pageSize; offset < end; offset += _pageSize)
+            _data[offset] = 0;
+    }
+}
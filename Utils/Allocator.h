@@ -0,0 +1,89 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+
+#ifndef ALLOCATOR_H
+#define ALLOCATOR_H
+
+#include "MappedFile.h"
+
+#include <string>
+#include <cstddef>
+
+// Placement of the large blocks of memory (the features matrices of CDataMatrix: kernel matrices,
+// and datasets as well), that the system would otherwise place in 4 KB pages on the NUMA node of
+// the thread allocating them:
+//  - Huge pages: 'transparent' asks the system to back the block by huge pages when it can
+//    (madvise), 'explicit' takes them from the huge pages reserved by the administrator
+//    (/proc/sys/vm/nr_hugepages), falling back to transparent ones if there is not enough.
+//  - NUMA: 'interleave' spreads the pages over all the nodes, in turn (mbind), 'partition' cuts
+//    the block in one contiguous range of rows by thread, each range being touched first by its
+//    thread, so that its pages land on the node running it (the threads are spread over the nodes
+//    with OMP_PROC_BIND=spread). The block is thus spread over the nodes of the threads, but only
+//    the loops over the rows with a static schedule (ie: the RBF values of a gamma sweep, see
+//    CKernel::fillRbfFromSqrDist) read pages of their own node: the kernel values are computed
+//    by tiles with a dynamic schedule, and the learners run in a single thread.
+// Blocks smaller than a huge page keep the default allocation. The placement obtained for the
+// largest block is reported by getPlacement().
+class CAllocator
+{
+public:
+    enum EHugePages { HUGEPAGES_NONE, HUGEPAGES_TRANSPARENT, HUGEPAGES_EXPLICIT };
+    enum ENuma      { NUMA_NONE, NUMA_INTERLEAVE, NUMA_PARTITION };
+
+    // Constructor / Destructor (the cycle of life!)
+    CAllocator();
+    CAllocator(const std::string& _hugePages, const std::string& _numa, int _nbThreads = 1);
+    ~CAllocator()   { }
+
+    // True if the blocks are placed as the system does by default (nothing to allocate here)
+    bool            isDefault() const   { return m_hugePages == HUGEPAGES_NONE && m_numa == NUMA_NONE; }
+
+    // Allocate a block of memory, of '_nbRows' rows of '_rowSize' bytes, released with the
+    // returned mapping. Returns NULL if the block keeps the default allocation.
+    CMappedFile*    allocate(size_t _nbRows, size_t _rowSize);
+
+    // Placement of the largest block allocated
+    std::string     getPlacement() const    { return m_placement; }
+
+    // True if the parameter value is a known mode (see the constructor)
+    static bool     isHugePagesMode(const std::string& _hugePages);
+    static bool     isNumaPlacement(const std::string& _numa);
+
+    // Allocator used by the matrices (see CDataMatrix::init)
+    static CAllocator&  getDefault();
+
+    // Size of the huge pages, and number of NUMA nodes of the system
+    static size_t   getHugePageSize();
+    static int      getNbNodes();
+
+private:
+    // Interleave the pages of a block over all the nodes (false if the system refuses)
+    bool            interleave(void* _data, size_t _size) const;
+
+    // Touch the first byte of each page, a contiguous range of rows by thread
+    void            partition(char* _data, size_t _nbRows, size_t _rowSize, size_t _pageSize) const;
+
+    EHugePages      m_hugePages;
+    ENuma           m_numa;
+    int             m_nbThreads;
+
+    size_t          m_largestSize;
+    std::string     m_placement;
+};
+
+#endif // ALLOCATOR_H
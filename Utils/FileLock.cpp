@@ -0,0 +1,80 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+
+#include "FileLock.h"
+#include "MappedFile.h"
+
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+// True if the descriptor is still the file named _sFilename (which may have been removed, and
+// created again, by the previous holder of the lock)
+static bool isSameFile(int _fd, const std::string& _sFilename)
+{
+    int fd = CMappedFile::openDescriptor(_sFilename.c_str(), O_RDWR);
+    if (fd < 0)
+        return false;
+
+    struct stat st1, st2;
+    bool bSame = fstat(_fd, &st1) == 0 && fstat(fd, &st2) == 0 &&
+                 st1.st_dev == st2.st_dev && st1.st_ino == st2.st_ino;
+
+    close(fd);
+    return bSame;
+}
+
+
+// Constructor: waits for the lock (again, if the lock file was removed in the meantime)
+CFileLock::CFileLock(const std::string& _sFilename)
+{
+    m_sFilename = _sFilename;
+
+    while (true)
+    {
+        m_fd = CMappedFile::openDescriptor(m_sFilename.c_str(), O_RDWR|O_CREAT, 0666);
+        if (m_fd < 0)
+            return;
+
+        if (flock(m_fd, LOCK_EX) != 0)
+        {
+            close(m_fd);
+            m_fd = -1;
+            return;
+        }
+
+        if ( isSameFile(m_fd, m_sFilename) )
+            return;
+
+        close(m_fd);
+    }
+}
+
+
+// Destructor: removes the lock file, then releases the lock
+CFileLock::~CFileLock()
+{
+    if (m_fd >= 0)
+    {
+        CMappedFile::remove( m_sFilename.c_str() );
+        flock(m_fd, LOCK_UN);
+        close(m_fd);
+    }
+}
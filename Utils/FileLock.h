@@ -0,0 +1,49 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+
+#ifndef FILE_LOCK_H
+#define FILE_LOCK_H
+
+#include <string>
+
+// Exclusive lock shared by processes (POSIX flock on a lock file, created if needed; a name
+// starting with "shm:" designates a shared memory object, see CMappedFile). The lock is
+// acquired by the constructor, which waits for the other processes, and released by the
+// destructor, which also removes the lock file. A process that was waiting on a removed lock
+// file then locks the new one, so that a single process holds the lock at any time.
+class CFileLock
+{
+public:
+    // Constructor / Destructor (the cycle of life!)
+    CFileLock(const std::string& _sFilename);
+    ~CFileLock();
+
+    // True if the lock is held (false if the lock file could not be created)
+    bool        isLocked() const    { return m_fd >= 0; }
+
+private:
+    // Not copyable (the lock is released only once)
+    CFileLock(const CFileLock&);
+    CFileLock& operator=(const CFileLock&);
+
+    // Lock file name and descriptor
+    std::string m_sFilename;
+    int         m_fd;
+};
+
+#endif // FILE_LOCK_H
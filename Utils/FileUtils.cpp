@@ -178,4 +178,32 @@ vector<CStrValue> parseCmdLine(StrValueMap & _argMap, int _argc, char* _argv[],
 }
 
 
+static unsigned long long hashBytes(const char* _bytes, size_t _n, unsigned long long _hash)
+{
+    for (size_t i = 0; i < _n; ++i)
+    {
+        _hash ^= (unsigned char)_bytes[i];
+        _hash *= 1099511628211ULL;
+    }
+
+    return _hash;
+}
+
+unsigned long long hashString(const string& _str, unsigned long long _hash /*= HASH_SEED*/)
+{
+    return hashBytes(_str.data(), _str.size(), _hash);
+}
+
+unsigned long long hashFile(const char* _sFilename, unsigned long long _hash /*= HASH_SEED*/)
+{
+    ifstream file(_sFilename, ios::binary);
+    char buffer[65536];
+
+    while ( file.read(buffer, sizeof(buffer)) || file.gcount() > 0 )
+        _hash = hashBytes(buffer, file.gcount(), _hash);
+
+    return _hash;
+}
+
+
 } // namespace FileUtils
@@ -55,6 +55,12 @@ std::vector<std::string> splitToArray(const std::string& _str, const std::string
 std::vector<CStrValue> parseCmdLine(StrValueMap & _argMap, int _argc, char* _argv[]);
 std::vector<CStrValue> parseCmdLine(StrValueMap & _argMap, int _argc, char* _argv[], bool & _bHelp);
 
+// 64 bits FNV-1a hash of a string / of a file content (continuing from a previous hash, if any)
+const unsigned long long HASH_SEED = 14695981039346656037ULL;
+
+unsigned long long hashString(const std::string& _str, unsigned long long _hash = HASH_SEED);
+unsigned long long hashFile(const char* _sFilename, unsigned long long _hash = HASH_SEED);
+
 
 template<class TYPE>
 STabInfo readTab(const char* _sFilename, std::vector< std::vector<TYPE> >& _refTab)
@@ -0,0 +1,172 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+#include "MappedFile.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+
+
+// Constructor
+CMappedFile::CMappedFile()
+{
+    m_pData = NULL;
+    m_size  = 0;
+}
+
+
+// Prefix of the names of shared memory objects
+static const char   SHM_PREFIX[] = "shm:";
+static const size_t SHM_PREFIX_LENGTH = sizeof(SHM_PREFIX) - 1;
+
+
+// Open a file, or a shared memory object
+int CMappedFile::openDescriptor(const char* _sFilename, int _flags, int _mode /*= 0644*/)
+{
+    if (strncmp(_sFilename, SHM_PREFIX, SHM_PREFIX_LENGTH) == 0)
+        return shm_open(_sFilename + SHM_PREFIX_LENGTH, _flags, _mode);
+
+    return ::open(_sFilename, _flags, _mode);
+}
+
+
+// Remove a file, or a shared memory object
+bool CMappedFile::remove(const char* _sFilename)
+{
+    if (strncmp(_sFilename, SHM_PREFIX, SHM_PREFIX_LENGTH) == 0)
+        return shm_unlink(_sFilename + SHM_PREFIX_LENGTH) == 0;
+
+    return unlink(_sFilename) == 0;
+}
+
+
+// Map an existing file
+bool CMappedFile::open(const char* _sFilename, bool _bWritable /*= false*/)
+{
+    close();
+
+    int fd = openDescriptor(_sFilename, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    void* ptr = mmap(NULL, info.st_size, _bWritable ? PROT_READ|PROT_WRITE : PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+
+    if (ptr == MAP_FAILED)
+        return false;
+
+    m_pData = ptr;
+    m_size  = info.st_size;
+
+    return true;
+}
+
+
+// Create a file and map it in shared mode
+bool CMappedFile::create(const char* _sFilename, size_t _size)
+{
+    close();
+
+    if (_size == 0)
+        return false;
+
+    int fd = openDescriptor(_sFilename, O_RDWR|O_CREAT|O_TRUNC);
+    if (fd < 0)
+        return false;
+
+    if (ftruncate(fd, _size) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    void* ptr = mmap(NULL, _size, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+
+    if (ptr == MAP_FAILED)
+        return false;
+
+    m_pData = ptr;
+    m_size  = _size;
+
+    return true;
+}
+
+
+// Map anonymous memory
+bool CMappedFile::allocate(size_t _size, bool _bHugePages /*= false*/)
+{
+    close();
+
+    if (_size == 0)
+        return false;
+
+    int flags = MAP_PRIVATE|MAP_ANONYMOUS;
+#ifdef MAP_HUGETLB
+    if (_bHugePages)
+        flags |= MAP_HUGETLB;
+#else
+    if (_bHugePages)
+        return false;
+#endif
+
+    void* ptr = mmap(NULL, _size, PROT_READ|PROT_WRITE, flags, -1, 0);
+
+    if (ptr == MAP_FAILED)
+        return false;
+
+    m_pData = ptr;
+    m_size  = _size;
+
+    return true;
+}
+
+
+// Read ahead a range of the mapping (rounded to whole pages)
+void CMappedFile::prefetch(size_t _offset, size_t _length) const
+{
+    if (m_pData == NULL || _offset >= m_size)
+        return;
+
+    size_t pageSize = sysconf(_SC_PAGESIZE);
+    size_t first    = _offset - _offset % pageSize;
+    size_t last     = std::min(_offset + _length, m_size);
+
+    madvise((char*)m_pData + first, last - first, MADV_WILLNEED);
+}
+
+
+// Release the mapping
+void CMappedFile::close()
+{
+    if (m_pData != NULL)
+        munmap(m_pData, m_size);
+
+    m_pData = NULL;
+    m_size  = 0;
+}
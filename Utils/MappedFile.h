@@ -0,0 +1,72 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <cstddef>
+
+// A file mapped in memory (POSIX mmap). The mapping is released by close() or by the destructor.
+// A name starting with "shm:" designates a POSIX shared memory object instead of a file
+// (ie: "shm:/pbsc_K"), so that processes can map the same pages without any disk file.
+// Anonymous memory (without any file) can also be mapped, see CAllocator.
+class CMappedFile
+{
+public:
+    // Constructor / Destructor (the cycle of life!)
+    CMappedFile();
+    virtual ~CMappedFile()      { close(); }
+
+    // Map an existing file (read only, or copy-on-write if _bWritable==true)
+    bool        open(const char* _sFilename, bool _bWritable = false);
+
+    // Create (or truncate) a file of the given size, filled with zeros, and map it in shared
+    // mode: the modifications of the memory are written into the file
+    bool        create(const char* _sFilename, size_t _size);
+
+    // Map anonymous memory, filled with zeros. With _bHugePages==true, the memory is made of the
+    // huge pages reserved by the system (MAP_HUGETLB): the size must be a multiple of their size
+    bool        allocate(size_t _size, bool _bHugePages = false);
+
+    // Announce that a range of the mapping will be read soon (the system reads it ahead)
+    void        prefetch(size_t _offset, size_t _length) const;
+
+    // Open a file (or a shared memory object) with the flags of the POSIX 'open' function
+    static int  openDescriptor(const char* _sFilename, int _flags, int _mode = 0644);
+
+    // Remove a file (or a shared memory object)
+    static bool remove(const char* _sFilename);
+
+    // Release the mapping
+    void        close();
+
+    // Mapped memory
+    void*       data() const    { return m_pData; }
+    size_t      size() const    { return m_size;  }
+    bool        isOpen() const  { return m_pData != NULL; }
+
+private:
+    // Not copyable (the mapping is released only once)
+    CMappedFile(const CMappedFile&);
+    CMappedFile& operator=(const CMappedFile&);
+
+    void*       m_pData;
+    size_t      m_size;
+};
+
+#endif // MAPPED_FILE_H
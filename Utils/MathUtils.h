@@ -43,6 +43,7 @@ void    assign(std::vector<double> *_ptrVector, gsl_vector*  _vector1);
 
 // Scalar product (aka Dot product)
 double  dot( gsl_vector*  _vector1,  gsl_vector*  _vector2);
+double  dot( gsl_vector*  _vector1,  gsl_vector*  _vector2, gsl_vector*  _weights);   // sum of w_i*x_i*y_i
 
 // Matrix by vector product
 void    mvProduct(gsl_vector*  _ptrVector, gsl_matrix* _matrix1, gsl_vector*  _vector2,  bool bTransposeMatrix = false);
@@ -106,6 +107,16 @@ inline double dot( gsl_vector*  _vector1,  gsl_vector*  _vector2)
     return result;
 }
 
+inline double dot( gsl_vector*  _vector1,  gsl_vector*  _vector2, gsl_vector*  _weights)
+{
+    double result = 0.0;
+
+    for (unsigned int i = 0; i < _vector1->size; ++i)
+        result += gsl_vector_get(_weights, i) * gsl_vector_get(_vector1, i) * gsl_vector_get(_vector2, i);
+
+    return result;
+}
+
 
 inline double sum(gsl_vector*  _vector)
 {
@@ -0,0 +1,98 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+#include "VectorMath.h"
+
+#include <cstring>
+#include <stdint.h>
+
+// Compile the batch functions for several instruction sets, selected at run time
+#if defined(__GNUC__) && defined(__x86_64__) && !defined(__clang__)
+#define VECTOR_MATH_CLONES __attribute__((target_clones("avx512f","avx2","default")))
+#else
+#define VECTOR_MATH_CLONES
+#endif
+
+namespace VectorMath
+{
+
+// Bounds of the exp argument (the result stays a normal number)
+static const double EXP_MIN     = -708.0;
+static const double EXP_MAX     =  709.0;
+
+// Constants for the range reduction x = n*ln(2) + r
+static const double LOG2E       = 1.4426950408889634074;
+static const double LN2_HI      = 6.93147180369123816490e-01;
+static const double LN2_LO      = 1.90821492927058770002e-10;
+static const double ROUND_MAGIC = 6755399441055744.0;    // 1.5 * 2^52
+
+
+// exp(x) = 2^n * exp(r), with n = round(x/ln(2)) and |r| <= ln(2)/2.
+// exp(r) is approximated by its Taylor polynomial of degree 13 (truncation error < 1e-17).
+static inline double expKernel(double _x)
+{
+    double x = _x < EXP_MIN ? EXP_MIN : ( _x > EXP_MAX ? EXP_MAX : _x );
+
+    // n = round(x/ln(2)), obtained in the low bits of t
+    double t = x * LOG2E + ROUND_MAGIC;
+    double n = t - ROUND_MAGIC;
+    double r = (x - n * LN2_HI) - n * LN2_LO;
+
+    double p = 1.0/6227020800.0;
+    p = p * r + 1.0/479001600.0;
+    p = p * r + 1.0/39916800.0;
+    p = p * r + 1.0/3628800.0;
+    p = p * r + 1.0/362880.0;
+    p = p * r + 1.0/40320.0;
+    p = p * r + 1.0/5040.0;
+    p = p * r + 1.0/720.0;
+    p = p * r + 1.0/120.0;
+    p = p * r + 1.0/24.0;
+    p = p * r + 1.0/6.0;
+    p = p * r + 0.5;
+    p = p * r + 1.0;
+    p = p * r + 1.0;
+
+    // 2^n is built directly from its exponent bits (unsigned arithmetic: the low bits of t hold
+    // n in two's complement, and the shift drops the high ones)
+    uint64_t bits;
+    std::memcpy(&bits, &t, sizeof(bits));
+    bits = (bits << 52) + ((uint64_t)1023 << 52);
+
+    double scale;
+    std::memcpy(&scale, &bits, sizeof(scale));
+
+    return _x < EXP_MIN ? 0.0 : p * scale;
+}
+
+
+VECTOR_MATH_CLONES
+void exp(double* _x, int _n)
+{
+    for (int i = 0; i < _n; ++i)
+        _x[i] = expKernel(_x[i]);
+}
+
+
+VECTOR_MATH_CLONES
+void tanh(double* _x, int _n)
+{
+    for (int i = 0; i < _n; ++i)
+        _x[i] = 1.0 - 2.0 / ( expKernel(2.0 * _x[i]) + 1.0 );
+}
+
+} // namespace VectorMath
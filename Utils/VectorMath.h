@@ -0,0 +1,44 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+#ifndef VECTOR_MATH_H
+#define VECTOR_MATH_H
+
+// Batch evaluation of transcendental functions on arrays of doubles (in place).
+//
+// The loops are branch-free so that the compiler vectorizes them. On x86-64 with GCC, they are
+// compiled for AVX-512, AVX2 and the baseline instruction set, and the best version is selected
+// at run time according to the processor (function multi-versioning).
+//
+// Accuracy (compared to the libm 'exp' and 'tanh' functions, in double precision):
+//  - exp  : relative error below 3e-16 (about 1 ulp) on [-708, 709]. Values below -708
+//           give 0.0 (libm returns a denormal number smaller than 4e-308). Values above 709
+//           are clamped to exp(709) (the built-in kernels never reach them).
+//  - tanh : computed as 1 - 2/(exp(2x)+1), absolute error below 4e-16 (the relative error
+//           may be larger when |tanh(x)| is much smaller than 1e-3).
+namespace VectorMath
+{
+
+// _x[i] = exp(_x[i]) , for i = 0 .. _n-1
+void    exp(double* _x, int _n);
+
+// _x[i] = tanh(_x[i]) , for i = 0 .. _n-1
+void    tanh(double* _x, int _n);
+
+} // namespace VectorMath
+
+#endif // VECTOR_MATH_H
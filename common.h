@@ -18,11 +18,32 @@
 #define COMMON_H
 
 #include "Datas/Kernel.h"
+#include "Datas/CachedKernelMatrix.h"
+#include "Datas/OutOfCoreKernelMatrix.h"
+#include "Datas/FloatKernelMatrix.h"
+#include "Datas/PackedKernelMatrix.h"
+#include "Datas/SparseKernelMatrix.h"
+#include "Datas/FactoredKernelMatrix.h"
+#include "Datas/Nystrom.h"
+#include "Datas/Coreset.h"
+#include "Datas/FeatureMap.h"
+#include "Datas/KernelFeatures.h"
+#include "Datas/GammaSelector.h"
+#include "Datas/MemoryPlanner.h"
+#include "Datas/DataPipeline.h"
+#include "Classifiers/LinearClassifier.h"
 #include "Utils/FileUtils.h"
 #include "Utils/MathUtils.h"
+#include "Utils/FileLock.h"
+#include "Utils/MappedFile.h"
+#include "Utils/Allocator.h"
 #include <iostream>
 #include <iomanip>
 #include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <unistd.h>
+#include <ctime>
 
 #define ERROR(x) { cout << x << endl; return EXIT_FAILURE; }
 
@@ -53,21 +74,670 @@ const char* STR_HEADER =
     ;
 
 
+// Check the memory placement parameters (-alloc.hugepages, -alloc.numa, see CAllocator).
+// Returns the description of the first invalid one (empty if both of them are valid).
+std::string checkAllocParameters(StrValueMap& _argMap)
+{
+    std::string hugePages = _argMap.count("alloc.hugepages") ? (std::string)_argMap["alloc.hugepages"] : "0";
+    std::string numa      = _argMap.count("alloc.numa") ? (std::string)_argMap["alloc.numa"] : "0";
+
+    if ( !CAllocator::isHugePagesMode(hugePages) )
+        return "Unknown huge pages mode '" + hugePages + "' (ie: 'transparent' or 'explicit').";
+
+    if ( !CAllocator::isNumaPlacement(numa) )
+        return "Unknown NUMA placement '" + numa + "' (ie: 'interleave' or 'partition').";
+
+    return "";
+}
+
+
+// Check the parameters given by the user (and their combinations) before any computation.
+// Returns the description of the first invalid one (empty if all of them are valid).
+std::string checkParameters(StrValueMap& _argMap)
+{
+    CKernel     kernel(_argMap);
+    std::string kernelName = kernel.serialize()["kernel"];
+    std::string gamma      = _argMap.count("kernel.gamma") ? (std::string)_argMap["kernel.gamma"] : "";
+
+    // Precision of the train matrix values
+    std::string precision = _argMap.count("precision") ? (std::string)_argMap["precision"] : "double";
+
+    if (precision != "double" && precision != "float")
+        return "Unknown precision '" + precision + "' (ie: 'double' or 'float').";
+
+    // Memory placement of the matrices
+    std::string strError = checkAllocParameters(_argMap);
+    if ( !strError.empty() )
+        return strError;
+
+    // A single representation of the train matrix (see createTrainKernelMatrix), the packed
+    // one being in the precision given by -precision
+    std::vector<std::string> storage;
+
+    const char* positive[] = { "nystrom.m", "cacheMB", "kernel.cutoff", "rff.D" };
+    for (int i = 0; i < 4; ++i)
+    {
+        if ( _argMap.count(positive[i]) > 0 && (double)_argMap[ positive[i] ] > 0 )
+            storage.push_back( positive[i] );
+    }
+
+    if ( _argMap.count("factored") > 0 && (bool)_argMap["factored"] )
+        storage.push_back("factored");
+
+    if ( _argMap.count("outOfCore") > 0 && (std::string)_argMap["outOfCore"] != "0" )
+        storage.push_back("outOfCore");
+
+    if ( _argMap.count("packed") > 0 && (bool)_argMap["packed"] )
+        storage.push_back("packed");
+    else if (precision == "float")
+        storage.push_back("precision float");
+
+    if (storage.size() > 1)
+        return "-" + storage[0] + " and -" + storage[1] + " can not be combined: they give different train matrices.";
+
+    // Gamma selected from the training examples (see selectAutoGamma)
+    if (gamma == "auto" && kernelName != "RBF")
+        return "An automatic gamma (-kernel.gamma auto) requires the RBF kernel.";
+
+    // Sparse train matrix of the RBF kernel values above a cutoff (see CSparseKernelMatrix)
+    double cutoff = _argMap.count("kernel.cutoff") ? (double)_argMap["kernel.cutoff"] : 0.0;
+
+    if ( cutoff != 0.0 && (cutoff < 0.0 || cutoff >= 1.0) )
+        return "The kernel cutoff must be in (0,1), or 0 for the exact matrix.";
+
+    if ( cutoff > 0.0 && kernelName != "RBF" )
+        return "A kernel cutoff requires the RBF kernel.";
+
+    // Random Fourier features approximate the RBF kernel only (see CRandomFeatures)
+    if ( _argMap.count("rff.D") > 0 && (double)_argMap["rff.D"] > 0 && kernelName != "RBF" )
+        return "Random Fourier features (-rff.D) require the RBF kernel.";
+
+    // Exact features exist for some kernels only
+    if ( _argMap.count("factored") > 0 && (bool)_argMap["factored"] && !CKernelFeatures::isSupported(kernel) )
+        return "-factored requires the LINEAR kernel, or the POLY kernel with an integer d >= 1, s > 0 and c >= 0.";
+
+    // A gamma sweep (see getGammaSweep) works on exact kernel matrices, entirely stored in memory
+    if ( kernelName == "RBF" && !gamma.empty() && gamma != "auto"
+         && ((std::vector<double>)_argMap["kernel.gamma"]).size() > 1 )
+    {
+        const char* exclusive[] = { "cacheMB", "nystrom.m", "rff.D", "factored", "kernel.cutoff", "coreset.size" };
+        for (int i = 0; i < 6; ++i)
+        {
+            if ( _argMap.count(exclusive[i]) > 0 && (double)_argMap[ exclusive[i] ] > 0 )
+                return std::string("A gamma sweep can not be combined with -") + exclusive[i] + ".";
+        }
+
+        if ( _argMap.count("outOfCore") > 0 && (std::string)_argMap["outOfCore"] != "0" )
+            return "A gamma sweep can not be combined with -outOfCore.";
+
+        if ( _argMap.count("precision") > 0 && (std::string)_argMap["precision"] == "float" )
+            return "A gamma sweep can not be combined with -precision float.";
+
+        if ( _argMap.count("packed") > 0 && (bool)_argMap["packed"] )
+            return "A gamma sweep can not be combined with -packed.";
+    }
+
+    return "";
+}
+
+
 CDataMatrix createKernelMatrix(CDataMatrix _data1, CDataMatrix _data2, CKernel _kernel)
 {
     CDataMatrix K;
 
-    K.init(_data1.nbEx, _data2.nbEx+1);
+    K.init(_data1.nbEx, _data2.nbEx+1, (_data1.Y != NULL));
 
     gsl_matrix_view view = gsl_matrix_submatrix(K.X, 0, 0, _data1.nbEx, _data2.nbEx);
     _kernel.fillKernelMatrix(_data1, _data2, &view.matrix);
 
     K.setCol(_data2.nbEx, 1.0); // bias
 
-    MathUtils::assign(K.Y, _data1.Y);
+    if (_data1.Y != NULL)
+        MathUtils::assign(K.Y, _data1.Y);
 
     return K;
 }
 
 
+// Name of the file keeping a kernel matrix in the persistent cache directory given by the
+// 'kernelCache' parameter ("" if there is no such directory). The name is a hash of the content
+// of the dataset files and of the kernel parameters, so that a modified file is never reused.
+// With 'kernelCache=shm', the matrix is kept in a POSIX shared memory object instead (see
+// CMappedFile), so that concurrent processes map the same pages.
+std::string kernelCacheFilename(StrValueMap& _argMap, CKernel _kernel, const std::string& _sFile1,
+                                const std::string& _sFile2)
+{
+    std::string strDir = _argMap["kernelCache"];
+    if (strDir == "0")
+        return "";
+
+    std::ostringstream kernelStr;
+    FileUtils::writeStrValueMap(_kernel.serialize(), kernelStr);
+
+    unsigned long long hash = FileUtils::hashFile( _sFile1.c_str() );
+    hash = FileUtils::hashFile( _sFile2.c_str(), hash );
+    hash = FileUtils::hashString( kernelStr.str(), hash );
+
+    // Merged training examples (-dedup) and coresets give smaller matrices
+    if ( _argMap.count("dedup") > 0 && (bool)_argMap["dedup"] )
+        hash = FileUtils::hashString( "dedup", hash );
+
+    if ( _argMap.count("coreset.size") > 0 && (int)_argMap["coreset.size"] > 0 )
+        hash = FileUtils::hashString( "coreset" + (std::string)_argMap["coreset.size"] + "/" + (std::string)_argMap["seed"], hash );
+
+    std::ostringstream filename;
+    filename << (strDir == "shm" ? "shm:/pbsc_K_" : strDir + "/K_") << std::hex << std::setw(16) << std::setfill('0') << hash << ".kmat";
+
+    return filename.str();
+}
+
+
+// Same as above, but the matrix is first looked for in the persistent cache file '_sCacheFile'
+// (mapped in memory if found). Otherwise, it is computed, saved into that file, and mapped.
+// Processes using the same cache file are serialized by a lock: the matrix is computed by the
+// first one only, and all of them then map the same pages (until they write into them).
+CDataMatrix createKernelMatrix(CDataMatrix _data1, CDataMatrix _data2, CKernel _kernel,
+                               const std::string& _sCacheFile)
+{
+    CDataMatrix K;
+
+    if ( _sCacheFile.empty() )
+        return createKernelMatrix(_data1, _data2, _kernel);
+
+    CFileLock lock(_sCacheFile + ".lock");
+
+    if ( K.mapBinaryFile( _sCacheFile.c_str() ) && K.nbEx == _data1.nbEx && K.nbFt == _data2.nbEx+1 )
+    {
+        std::cout << "  Mapped from '" << _sCacheFile << "'." << std::endl;
+        return K;
+    }
+
+    K.free();
+    K = createKernelMatrix(_data1, _data2, _kernel);
+
+    if ( K.saveToBinaryFile( _sCacheFile.c_str() ) )
+    {
+        // The computed matrix is replaced by the saved one (a single copy in memory)
+        CDataMatrix mapped;
+        if ( mapped.mapBinaryFile( _sCacheFile.c_str() ) )
+        {
+            K.free();
+            K = mapped;
+        }
+        std::cout << "  Saved into '" << _sCacheFile << "'." << std::endl;
+    }
+    else
+    {
+        CMappedFile::remove( _sCacheFile.c_str() );
+        std::cout << "  Unable to save into '" << _sCacheFile << "'." << std::endl;
+    }
+
+    return K;
+}
+
+
+// Size in megabytes, as displayed by the programs (ie: "189.6 MB")
+std::string formatMB(double _bytes)
+{
+    std::ostringstream str;
+    str << std::fixed << std::setprecision(1) << _bytes/(1024.0*1024.0) << " MB";
+    return str.str();
+}
+
+
+// Create the training kernel matrix (train vs train, plus the bias column) in the
+// representation selected by the parameters:
+//  - nystrom.m > 0 : Nystrom low-rank approximation from 'nystrom.m' landmarks (selected by the
+//                  'nystrom.landmarks' method), the matrix is never formed (see CFactoredKernelMatrix)
+//  - cacheMB > 0 : columns are computed when the learner needs them, and the most recently
+//                  used ones are kept in a cache of 'cacheMB' megabytes (see CCachedKernelMatrix)
+//  - kernel.cutoff > 0 : RBF kernel values below the cutoff are set to 0, and the matrix is stored
+//                  in sparse form (see CSparseKernelMatrix)
+//  - packed      : only the lower triangle of the matrix is computed and stored in memory, in
+//                  double or single precision (see CPackedKernelMatrix)
+//  - precision=float : the whole matrix is computed and stored in memory, in single precision
+//                  (see CFloatKernelMatrix)
+//  - outOfCore   : the whole matrix is computed into a scratch file of the 'outOfCore'
+//                  directory, mapped in memory (see COutOfCoreKernelMatrix)
+//  - otherwise   : the whole matrix is computed and stored in memory (or mapped from the
+//                  persistent cache file '_sCacheFile', if any)
+// Returns NULL if the scratch file can not be created in the 'outOfCore' directory.
+CKernelMatrix* createTrainKernelMatrix(CDataMatrix _train, CKernel _kernel, StrValueMap& _argMap,
+                                       const std::string& _sCacheFile = "")
+{
+    double cacheMB     = _argMap["cacheMB"];
+    int    nbLandmarks = _argMap.count("nystrom.m") ? (int)_argMap["nystrom.m"] : 0;
+
+    if (nbLandmarks > 0)
+    {
+        std::string   landmarks = _argMap.count("nystrom.landmarks") ? (std::string)_argMap["nystrom.landmarks"] : "UNIFORM";
+        unsigned long seed      = _argMap.count("seed") ? (int)_argMap["seed"] : time(NULL);
+
+        CNystrom nystrom(_kernel, nbLandmarks, landmarks, seed);
+        CFactoredKernelMatrix* K = new CFactoredKernelMatrix( nystrom.createFactor(_train) );
+        std::cout << "  Train matrix : " << K->nbEx << " x " << K->nbFt << " elements, Nystrom approximation of rank "
+                  << K->getRank() << " (" << nystrom.getLandmarks().size() << " landmarks)." << std::endl;
+        return K;
+    }
+
+    if (cacheMB > 0)
+    {
+        CCachedKernelMatrix* K = new CCachedKernelMatrix(_train, _kernel, cacheMB);
+        std::cout << "  Train matrix : " << K->nbEx << " x " << K->nbFt << " elements, computed on demand "
+                  << "(cache of " << K->getNbSlots() << " columns)." << std::endl;
+        return K;
+    }
+
+    double cutoff = _argMap.count("kernel.cutoff") ? (double)_argMap["kernel.cutoff"] : 0.0;
+
+    if (cutoff > 0)
+    {
+        CSparseKernelMatrix* K = new CSparseKernelMatrix(_train, _kernel, cutoff);
+        std::cout << "  Train matrix : " << K->nbEx << " x " << K->nbFt << " elements, " << K->getNbNonZeros()
+                  << " kernel values above the cutoff (" << 100.0 * K->getNbNonZeros() / ((double)K->nbEx*K->nbEx)
+                  << "%)." << std::endl;
+        return K;
+    }
+
+    std::string precision = _argMap.count("precision") ? (std::string)_argMap["precision"] : "double";
+
+    if ( _argMap.count("packed") && (bool)_argMap["packed"] )
+    {
+        CKernelMatrix* K;
+        size_t         size;
+
+        if (precision == "float")
+        {
+            CPackedKernelMatrix<float>* pK = new CPackedKernelMatrix<float>(_train, _kernel);
+            K = pK;  size = pK->getSize();
+        }
+        else
+        {
+            CPackedKernelMatrix<double>* pK = new CPackedKernelMatrix<double>(_train, _kernel);
+            K = pK;  size = pK->getSize();
+        }
+
+        std::cout << "  Train matrix : " << K->nbEx << " x " << K->nbFt << " elements, lower triangle in "
+                  << (precision == "float" ? "single" : "double") << " precision (" << formatMB(size) << ")." << std::endl;
+        return K;
+    }
+
+    if (precision == "float")
+    {
+        CFloatKernelMatrix* K = new CFloatKernelMatrix(_train, _kernel);
+        std::cout << "  Train matrix : " << K->nbEx << " x " << K->nbFt << " elements, in single precision ("
+                  << formatMB( K->getSize() ) << ")." << std::endl;
+        return K;
+    }
+
+    std::string scratchDir = _argMap.count("outOfCore") ? (std::string)_argMap["outOfCore"] : "0";
+
+    if (scratchDir != "0")
+    {
+        CMappedFile* pFile = COutOfCoreKernelMatrix::createScratchFile(scratchDir, _train.nbEx);
+        if (pFile == NULL)
+            return NULL;
+
+        COutOfCoreKernelMatrix* K = new COutOfCoreKernelMatrix(_train, _kernel, pFile);
+        std::cout << "  Train matrix : " << K->nbEx << " x " << K->nbFt << " elements, in a scratch file of "
+                  << formatMB( K->getFileSize() ) << "." << std::endl;
+        return K;
+    }
+
+    CDenseKernelMatrix* K = new CDenseKernelMatrix( createKernelMatrix(_train, _train, _kernel, _sCacheFile), true );
+    std::cout << "  Train matrix : " << K->nbEx << " x " << K->nbFt << " elements." << std::endl;
+    return K;
+}
+
+
+// Gamma of the RBF kernel selected without learning, when it is given as 'auto' (-kernel.gamma auto):
+// kernel-target alignment on 'gammaAuto.nb' random subsamples of 'gammaAuto.m' training examples,
+// or median heuristic (see CGammaSelector). The parameter is then replaced by the selected value.
+void selectAutoGamma(StrValueMap& _argMap, const CDataMatrix& _train)
+{
+    if ( _argMap.count("kernel.gamma") == 0 || (std::string)_argMap["kernel.gamma"] != "auto" )
+        return;
+
+    CKernel kernel(_argMap);
+    if ( (std::string)kernel.serialize()["kernel"] != "RBF" )
+        throw std::logic_error("[selectAutoGamma] An automatic gamma requires the RBF kernel.");
+
+    kernel.setNbThreads( _argMap.count("threads") ? (int)_argMap["threads"] : 1 );
+
+    int           nbSamples = _argMap.count("gammaAuto.m")  ? (int)_argMap["gammaAuto.m"]  : 500;
+    int           nbSubsets = _argMap.count("gammaAuto.nb") ? (int)_argMap["gammaAuto.nb"] : 5;
+    unsigned long seed      = _argMap.count("seed") ? (int)_argMap["seed"] : time(NULL);
+
+    std::cout << "* Selecting kernel gamma..." << std::endl;
+    CGammaSelector selector(kernel, nbSamples, nbSubsets, seed);
+    double gamma = selector.select(_train);
+
+    if ( selector.isAligned() )
+        std::cout << "  Kernel gamma = " << gamma << " (kernel-target alignment = " << selector.alignment(gamma) << ")." << std::endl;
+    else
+        std::cout << "  Kernel gamma = " << gamma << " (median heuristic)." << std::endl;
+
+    selector.free();
+    _argMap["kernel.gamma"] = gamma;
+}
+
+
+// Reduction of the training set to a weighted coreset of 'coreset.size' representatives (see
+// CCoreset), when that parameter is given. The training set is replaced by the coreset; the
+// indices of the representatives are returned (empty without coreset).
+std::vector<int> selectCoreset(StrValueMap& _argMap, CDataMatrix& _train)
+{
+    int size = _argMap.count("coreset.size") ? (int)_argMap["coreset.size"] : 0;
+
+    if (size <= 0 || size >= _train.nbEx)
+        return std::vector<int>();
+
+    CKernel kernel(_argMap);
+    kernel.setNbThreads( _argMap.count("threads") ? (int)_argMap["threads"] : 1 );
+
+    // The seed is kept in the parameters: the kernel cache files of a coreset depend on it
+    if (_argMap.count("seed") == 0)
+        _argMap["seed"] = (int)time(NULL);
+
+    unsigned long seed = (int)_argMap["seed"];
+
+    std::cout << "* Selecting coreset..." << std::endl;
+    CCoreset    coreset(kernel, size, seed);
+    CDataMatrix reduced = coreset.create(_train);
+
+    std::cout << "  " << reduced.nbEx << " representatives of " << _train.nbEx << " examples (weights from "
+              << gsl_vector_min(reduced.W) << " to " << gsl_vector_max(reduced.W) << ")." << std::endl;
+
+    _train.free();
+    _train = reduced;
+
+    return coreset.getRepresentatives();
+}
+
+
+// Gamma values of a RBF kernel sweep, given as a list (ie: -kernel.gamma 0.01;0.1;0.5;1).
+// Empty if the kernel is not RBF or if a single value is given (no sweep).
+// The options a sweep can not be combined with are rejected by checkParameters.
+std::vector<double> getGammaSweep(StrValueMap& _argMap, CKernel _kernel)
+{
+    std::vector<double> gammas;
+
+    if ( (std::string)_kernel.serialize()["kernel"] == "RBF" && _argMap.count("kernel.gamma") > 0 )
+        gammas = (std::vector<double>)_argMap["kernel.gamma"];
+
+    if (gammas.size() < 2)
+        gammas.clear();
+
+    return gammas;
+}
+
+
+// Check the parameters against the loaded datasets: Nystrom landmarks and explicit features
+// (-nystrom.m, -rff.D, -factored) are computed from dense examples only. The test set read by
+// blocks (-pipeline) is not loaded: its file '_sPipelinedFile' is only opened to know its format.
+// Returns the description of the first unsupported combination (empty if there is none).
+std::string checkDatasets(StrValueMap& _argMap, const CDataMatrix& _train, const CDataMatrix& _test,
+                          const std::string& _sPipelinedFile = "")
+{
+    bool bSparseTest = _test.isSparse();
+
+    if ( !_sPipelinedFile.empty() )
+    {
+        CDataStream stream;
+        bSparseTest = stream.open( _sPipelinedFile.c_str() ) && stream.isSparse();
+    }
+
+    if ( _train.isSparse() && _argMap.count("nystrom.m") > 0 && (int)_argMap["nystrom.m"] > 0 )
+        return "The Nystrom approximation (-nystrom.m) requires dense train examples, not sparse ones.";
+
+    const char* features[] = { "rff.D", "factored" };
+    for (int i = 0; i < 2; ++i)
+    {
+        if ( (_train.isSparse() || bSparseTest) && _argMap.count(features[i]) > 0 && (double)_argMap[ features[i] ] > 0 )
+            return std::string("Explicit features (-") + features[i] + ") require dense examples, not sparse ones.";
+    }
+
+    return "";
+}
+
+
+// Memory planning, when a limit is given (-memLimit, in megabytes): the memory needed by the
+// datasets, kernel matrices and learners is estimated before any kernel matrix is computed.
+// Unless the train matrix representation is given by the parameters, the most accurate one fitting
+// in the limit is selected (see CMemoryPlanner, Nystrom only for dense examples), and the
+// parameters are modified accordingly.
+// The statistics of the plan are added to '_stats' (nothing without limit). Returns the error
+// message if the problem does not fit ("" otherwise).
+std::string planMemory(StrValueMap& _argMap, const CDataMatrix& _train, const CDataMatrix& _test,
+                       StrValueMap& _stats)
+{
+    double limitMB = _argMap.count("memLimit") ? (double)_argMap["memLimit"] : 0.0;
+    if (limitMB <= 0)
+        return "";
+
+    std::cout << "* Planning memory..." << std::endl;
+
+    CKernel kernel(_argMap);
+    bool    bSweep    = !getGammaSweep(_argMap, kernel).empty();
+    bool    bFeatures = (_argMap.count("rff.D") && (double)_argMap["rff.D"] > 0)
+                     || (_argMap.count("factored") && (bool)_argMap["factored"]);
+
+    CMemoryPlanner planner(limitMB);
+    planner.setProblem( _train.nbEx, bFeatures ? 0 : _test.nbEx,
+                        CMemoryPlanner::datasetSize(_train) + CMemoryPlanner::datasetSize(_test), bSweep ? 2 : 1 );
+
+    bool        bPacked   = _argMap.count("packed") && (bool)_argMap["packed"];
+    std::string precision = _argMap.count("precision") ? (std::string)_argMap["precision"] : "double";
+    std::string scratch   = _argMap.count("outOfCore") ? (std::string)_argMap["outOfCore"] : "0";
+    bool        bFits;
+
+    if (_argMap.count("nystrom.m") && (int)_argMap["nystrom.m"] > 0)
+        bFits = planner.check(CMemoryPlanner::NYSTROM, (int)_argMap["nystrom.m"]);
+    else if (_argMap.count("cacheMB") && (double)_argMap["cacheMB"] > 0)
+        bFits = planner.check(CMemoryPlanner::CACHED, (double)_argMap["cacheMB"]);
+    else if ( bFeatures || scratch != "0" || (_argMap.count("kernel.cutoff") && (double)_argMap["kernel.cutoff"] > 0) )
+        bFits = planner.check(CMemoryPlanner::OTHER);
+    else if (bPacked)
+        bFits = planner.check(precision == "float" ? CMemoryPlanner::PACKED_FLOAT : CMemoryPlanner::PACKED);
+    else if (precision == "float")
+        bFits = planner.check(CMemoryPlanner::FLOAT);
+    else if (bSweep)
+        bFits = planner.check(CMemoryPlanner::DENSE);
+    else
+    {
+        bFits = planner.plan( !_train.isSparse() );
+
+        switch ( planner.getRepresentation() )
+        {
+        case CMemoryPlanner::PACKED:        _argMap["packed"] = 1;                                   break;
+        case CMemoryPlanner::PACKED_FLOAT:  _argMap["packed"] = 1;  _argMap["precision"] = "float"; break;
+        case CMemoryPlanner::CACHED:        _argMap["cacheMB"] = planner.getParameter();            break;
+        case CMemoryPlanner::NYSTROM:       _argMap["nystrom.m"] = (int)planner.getParameter();     break;
+        default:                                                                                    break;
+        }
+    }
+
+    std::string strTotal = formatMB( planner.getTotalSize() );
+
+    if (!bFits)
+        return "The problem does not fit in -memLimit " + (std::string)_argMap["memLimit"]
+               + " MB: the " + planner.getName() + " train matrix needs " + strTotal + ".";
+
+    std::cout << "  Train matrix : " << planner.getName() << ", " << strTotal << " of "
+              << limitMB << " MB." << std::endl;
+
+    _stats["Train matrix"]    = planner.getName();
+    _stats["Memory estimate"] = strTotal;
+
+    return "";
+}
+
+
+// Parameters of one step of a gamma sweep: the statistics, model and log files names
+// are suffixed by the gamma value (ie: "results.ini" -> "results_gamma0.1.ini")
+StrValueMap getSweepParameters(StrValueMap _argMap, double _gamma)
+{
+    std::ostringstream suffix;
+    suffix << "_gamma" << _gamma;
+
+    if ( _argMap.count("log") == 0 )
+        _argMap["log"] = "learner.log";
+
+    const char* files[] = { "stats", "model", "log" };
+    for (int i = 0; i < 3; ++i)
+    {
+        std::string strFile = _argMap[ files[i] ];
+        if (strFile == "0")
+            continue;
+
+        size_t pos = strFile.find_last_of('.');
+        if (pos == std::string::npos || strFile.find_first_of("/\\", pos) != std::string::npos)
+            pos = strFile.size();
+
+        _argMap[ files[i] ] = strFile.substr(0, pos) + suffix.str() + strFile.substr(pos);
+    }
+
+    _argMap["kernel.gamma"] = _gamma;
+
+    return _argMap;
+}
+
+
+// Squared distances matrix between two datasets, with the same layout than a kernel matrix
+// (plus the bias column, labels of '_data1'). The RBF kernel matrix of any gamma value is then
+// derived from it by 'fillRbfFromSqrDist'.
+CDataMatrix createSqrDistMatrix(CDataMatrix _data1, CDataMatrix _data2, CKernel _kernel)
+{
+    CDataMatrix D;
+
+    D.init(_data1.nbEx, _data2.nbEx+1);
+
+    gsl_matrix_view view = gsl_matrix_submatrix(D.X, 0, 0, _data1.nbEx, _data2.nbEx);
+    _kernel.fillSqrDistMatrix(_data1, _data2, &view.matrix);
+
+    D.setCol(_data2.nbEx, 1.0); // bias
+
+    MathUtils::assign(D.Y, _data1.Y);
+
+    return D;
+}
+
+
+// Fill the kernel matrix '_K' (same layout than '_D') from the squared distances matrix '_D'
+void fillRbfFromSqrDist(CDataMatrix _D, CDataMatrix _K, CKernel _kernel)
+{
+    gsl_matrix_view viewD = gsl_matrix_submatrix(_D.X, 0, 0, _D.nbEx, _D.nbFt-1);
+    gsl_matrix_view viewK = gsl_matrix_submatrix(_K.X, 0, 0, _K.nbEx, _K.nbFt-1);
+
+    _kernel.fillRbfFromSqrDist(&viewD.matrix, &viewK.matrix);
+}
+
+
+// Number of blocks of test examples read ahead of the kernel computation (-pipeline)
+#define PIPELINE_QUEUE_SIZE 4
+
+// Functors computing the rows of a test matrix from a block of test examples, against the
+// training examples (see createPipelinedMatrix)
+struct SKernelRows
+{
+    CDataMatrix     train;
+    CKernel         kernel;
+
+    CDataMatrix operator()(const CDataMatrix& _block)   { return createKernelMatrix(_block, train, kernel); }
+};
+
+struct SSqrDistRows
+{
+    CDataMatrix     train;
+    CKernel         kernel;
+
+    CDataMatrix operator()(const CDataMatrix& _block)   { return createSqrDistMatrix(_block, train, kernel); }
+};
+
+struct SFeatureRows
+{
+    CFeatureMap*    pFeatures;
+
+    CDataMatrix operator()(const CDataMatrix& _block)   { return pFeatures->transform(_block, true); }
+};
+
+
+// Test matrix computed while the test file '_sFile' is read (-pipeline): a thread reads the
+// file by blocks of '_blockSize' examples (see CDataPipeline), and the rows of each block are
+// computed by '_rows' as soon as it is read. '_M' is allocated once, from the number of examples
+// of the file (counted beforehand), and each block of rows is copied into its final rows then
+// freed: only one block is held apart from '_M'. Returns false if the file can not be opened or
+// contains an invalid example (then '_M' is empty).
+template<class TRows>
+bool createPipelinedMatrix(const std::string& _sFile, int _blockSize, TRows _rows, CDataMatrix& _M)
+{
+    CDataPipeline pipeline(_blockSize, PIPELINE_QUEUE_SIZE);
+
+    long nbTotal = CDataStream::countExamples( _sFile.c_str() );
+
+    if ( nbTotal < 0 || !pipeline.start( _sFile.c_str() ) )
+        return false;
+
+    CDataMatrix block;
+    int  nbRead;
+    long i = 0;
+
+    while ( (nbRead = pipeline.next(block)) > 0 )
+    {
+        CDataMatrix rows = _rows(block);
+        block.free();
+
+        // The file has more examples than counted (modified meanwhile)
+        if (i + rows.nbEx > nbTotal)
+        {
+            rows.free();
+            nbRead = -1;
+            break;
+        }
+
+        if (i == 0)
+            _M.init(nbTotal, rows.nbFt, (rows.Y != NULL));
+
+        gsl_matrix_view dest = gsl_matrix_submatrix(_M.X, i, 0, rows.nbEx, _M.nbFt);
+        gsl_matrix_memcpy(&dest.matrix, rows.X);
+
+        if (_M.Y != NULL)
+        {
+            gsl_vector_view labels = gsl_vector_subvector(_M.Y, i, rows.nbEx);
+            gsl_vector_memcpy(&labels.vector, rows.Y);
+        }
+
+        i += rows.nbEx;
+        rows.free();
+    }
+
+    pipeline.stop();
+
+    if (nbRead != 0 || i != _M.nbEx)
+    {
+        _M.free();
+        return false;
+    }
+
+    return true;
+}
+
+
+// Convert a classifier learned on a factored train matrix (one weight by training example,
+// plus the bias) into a linear classifier on the factor features (see primalWeights).
+// The given classifier is desallocated.
+CLinearClassifier* createPrimalClassifier(CClassifier* _classifier, CFactoredKernelMatrix* _K)
+{
+    CLinearClassifier* primal = new CLinearClassifier(_K->getRank()+1);
+    primal->init();
+
+    _K->primalWeights( ((CLinearClassifier*)_classifier)->getWeights(), primal->getWeights() );
+
+    _classifier->free();
+    delete _classifier;
+
+    return primal;
+}
+
+
 #endif // COMMON_H
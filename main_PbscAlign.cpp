@@ -26,7 +26,11 @@ const char* STR_USAGE =
     "\n"
     "Required parameters: \n"
     "    train_file      Training dataset file  (tab/space separated, one exemple per line, \n"
-    "                                            first column contains -1/+1 labels) \n"
+    "                                            first column contains -1/+1 labels). Sparse files \n"
+    "                                            list 'index:value' pairs after the label, \n"
+    "                                            with indices starting at 1) \n"
+    "                    Dense files whose features are all -1, 0 or +1 are also bit-packed: this only \n"
+    "                    speeds up the kernel computation, the features remain in memory as doubles \n"
     "\n"
     "Optionnal parameters: \n"
     "    test_file       Testing dataset file   (same format than the training dataset file) \n"
@@ -37,10 +41,71 @@ const char* STR_USAGE =
     "                        'RBF'    : Gaussian kernel    k(x,y) = exp(-gamma ||x-y||^2) \n"
     "                        'POLY'   : Polynomial kernel  k(x,y) = (s x*y+c)^d \n"
     "                        'TANH'   : Sigmoid kernel     k(x,y) = tanh(s x*y + c) \n"
-    "    -kernel.gamma   Kernel parameter gamma (default=0.1) \n"
+    "    -kernel.gamma   Kernel parameter gamma (default=0.1). A list of values (ie: 0.01;0.1;1) learns one \n"
+    "                    classifier by value, from a single squared distances matrix. The statistics, \n"
+    "                    model and log files names are then suffixed by '_gamma<value>' \n"
+    "                    Value 'auto' selects gamma without learning, by maximizing the kernel-target \n"
+    "                    alignment on random subsamples of the training examples (see pbsc_gamma) \n"
+    "    -gammaAuto.m    Examples by subsample, for -kernel.gamma auto (default=500) \n"
+    "    -gammaAuto.nb   Number of subsamples, for -kernel.gamma auto (default=5) \n"
     "    -kernel.d       Kernel parameter d (default=2.0) \n"
     "    -kernel.s       Kernel parameter s (default=1.0) \n"
     "    -kernel.c       Kernel parameter c (default=0.0) \n"
+    "    -kernel.cutoff  RBF kernel: train matrix values below that cutoff (ie: 1e-8) are set to 0. Only the \n"
+    "                    pairs of close examples are evaluated (with a k-d tree) and stored, in a sparse \n"
+    "                    matrix. Efficient for large gamma values (0=exact matrix, default=0) \n"
+    "    -threads        Number of threads computing the kernel matrices (0=all processors, default=1) \n"
+    "    -cacheMB        Compute the train matrix columns on demand, and keep the most recently used \n"
+    "                    ones in a cache of that size, in megabytes (0=store the whole matrix, default=0) \n"
+    "    -precision      Precision of the train matrix values, ie 'double' or 'float' (half the memory and \n"
+    "                    memory traffic; the learners still compute in double precision) (default='double') \n"
+    "    -packed         Store only the lower triangle of the (symmetric) train matrix: half the memory, \n"
+    "                    in the precision given by -precision (default=0) \n"
+    "    -outOfCore      Directory of a scratch file receiving the train matrix, mapped in memory, when the \n"
+    "                    matrix exceeds the memory (0=store the matrix in memory, default=0) \n"
+    "    -nystrom.m      Learn from a Nystrom low-rank approximation of the train matrix, computed from that \n"
+    "                    number of landmark examples, in O(n*m) memory. Dense train examples only \n"
+    "                    (0=exact matrix, default=0) \n"
+    "    -nystrom.landmarks  Landmarks selection, ie 'UNIFORM' or 'KMEANS++' (default='UNIFORM') \n"
+    "    -rff.D          Replace the RBF kernel by that number of random Fourier features (seeded by -seed). \n"
+    "                    The model then holds one weight by feature. Dense examples only (0=exact kernel, \n"
+    "                    default=0) \n"
+    "    -factored       LINEAR and POLY (integer d, s>0, c>=0) kernels: learn from the exact features of \n"
+    "                    the kernel, without forming the train matrix. The model then holds one weight \n"
+    "                    by feature. Efficient for few features, ie small d and input dimension. Other \n"
+    "                    kernels (and parameters), and sparse examples, are rejected (default=0) \n"
+    "    -kernelCache    Directory keeping the kernel matrices between executions, in binary files mapped \n"
+    "                    in memory (0=none, default=0). Value 'shm' keeps them in POSIX shared memory \n"
+    "                    instead: concurrent executions on the same data and kernel compute the matrices \n"
+    "                    once, and share their memory (the objects remain until removed from /dev/shm) \n"
+    "    -dedup          Merge the identical training examples (same label and features) into a single \n"
+    "                    example, weighted by its number of occurrences: the learned classifier is the \n"
+    "                    same, from a smaller kernel matrix (default=0) \n"
+    "    -coreset.size   Reduce the training set to that number of representative examples (selected by \n"
+    "                    k-means++ seeding in the kernel feature space, in each class), each one weighted \n"
+    "                    by the number of examples it represents: the kernel matrices are computed on the \n"
+    "                    representatives only (0=all examples, default=0) \n"
+    "    -memLimit       Memory limit, in megabytes. The memory needed by the datasets, kernel matrices and \n"
+    "                    learner is estimated before computing the matrices, and the execution stops if it \n"
+    "                    does not fit. Unless given by the parameters above, the train matrix is stored in \n"
+    "                    the most accurate form fitting in the limit: dense, packed, packed float, cached, \n"
+    "                    or Nystrom approximation (of dense examples). The choice is reported in the \n"
+    "                    statistics (0=none, default=0) \n"
+    "    -alloc.hugepages  Pages of the kernel matrices and datasets (of at least one huge page): \n"
+    "                    'transparent' asks the system for huge pages, 'explicit' takes the huge pages \n"
+    "                    reserved in /proc/sys/vm/nr_hugepages (or transparent ones if there is not \n"
+    "                    enough), fewer TLB misses (0=system pages, default=0) \n"
+    "    -alloc.numa     NUMA placement of the same pages: 'interleave' spreads them over all the nodes, \n"
+    "                    'partition' gives each thread (-threads) the pages of its own range of rows, on \n"
+    "                    its node (with OMP_PROC_BIND=spread), which spreads a matrix over the nodes of \n"
+    "                    the threads. Only the RBF values of a gamma sweep are then computed from local \n"
+    "                    pages: the kernel tiles are shared dynamically between the threads, and the \n"
+    "                    learner runs in a single thread. The placement obtained is reported in the \n"
+    "                    statistics (0=first touch, default=0) \n"
+    "    -pipeline       Read the test file by blocks of that number of examples, in a thread, while the \n"
+    "                    kernel values of the blocks already read are computed (at most 4 blocks wait): \n"
+    "                    the loading is hidden behind the computation. Not with -memLimit and -kernelCache, \n"
+    "                    which need the whole test set first (0=load the test file first, default=0) \n"
     "\n"
     "    -stopCriteria   Stopping criteria (default=1e-16) \n"
     "    -nIter          Maximum number of iterations (defaut=2e5) \n"
@@ -83,6 +148,18 @@ int main(int argc, char **argv)
     argDefault["config"]    = "config.ini";
     argDefault["stats"]     = "results.ini";
     argDefault["model"]     = "classifier.ini";
+    argDefault["threads"]   = 1;
+    argDefault["cacheMB"]   = 0;
+    argDefault["kernelCache"] = 0;
+    argDefault["outOfCore"] = 0;
+    argDefault["precision"] = "double";
+    argDefault["packed"]    = 0;
+    argDefault["factored"]  = 0;
+    argDefault["memLimit"]  = 0;
+    argDefault["dedup"]     = 0;
+    argDefault["alloc.hugepages"] = 0;
+    argDefault["alloc.numa"] = 0;
+    argDefault["pipeline"]  = 0;
 
     bool bHelp;
     vector<CStrValue> new_argv = FileUtils::parseCmdLine(argMap, argc, argv, bHelp);
@@ -104,6 +181,14 @@ int main(int argc, char **argv)
     
     argMap.insert(argDefault.begin(), argDefault.end());
 
+    // Parameters checked before any computation
+    string strError = checkParameters(argMap);
+    if ( !strError.empty() )
+        ERROR("  " << strError);
+
+    // Placement of the large matrices memory (-alloc.hugepages, -alloc.numa)
+    CAllocator::getDefault() = CAllocator(argMap["alloc.hugepages"], argMap["alloc.numa"], argMap["threads"]);
+
     // Load dataset files
     CDataMatrix train, test;
 
@@ -113,8 +198,25 @@ int main(int argc, char **argv)
     else
         ERROR("  Error with file '" << new_argv[1] << "'.");
 
+    // Identical training examples merged into weighted ones (-dedup)
+    if ( (bool)argMap["dedup"] )
+    {
+        int nbMerged = train.mergeDuplicates();
+        cout << "  " << nbMerged << " duplicates merged (" << train.nbEx << " distinct examples)." << endl;
+    }
+
+
+    // The test file is read while its kernel values are computed (-pipeline), unless the whole
+    // test set is needed before: to plan the memory (-memLimit) or to hash it (-kernelCache)
+    int  pipelineSize = argMap["pipeline"];
+    bool bPipeline    = new_argc > 2 && pipelineSize > 0
+                        && (double)argMap["memLimit"] <= 0 && (string)argMap["kernelCache"] == "0";
 
-    if (new_argc > 2)
+    if (new_argc > 2 && bPipeline)
+    {
+        cout << "* Test file read by blocks of " << pipelineSize << " examples, during the kernel computation." << endl;
+    }
+    else if (new_argc > 2)
     {
         cout << "* Loading test file..." << endl;
         if( test.loadFromFile( new_argv[2].c_str() ) )
@@ -125,67 +227,195 @@ int main(int argc, char **argv)
 
 
 
+    // Representations computed from dense examples only (-nystrom.m, -rff.D, -factored)
+    strError = checkDatasets(argMap, train, test, bPipeline ? new_argv[2] : "");
+    if ( !strError.empty() )
+        ERROR("  " << strError);
+
+    // Kernel gamma selected from the training examples (-kernel.gamma auto)
+    selectAutoGamma(argMap, train);
+
+    // Training set reduced to a weighted coreset (-coreset.size)
+    vector<int> coreset = selectCoreset(argMap, train);
+
+    // Kernel matrices representation fitting in the memory limit (-memLimit)
+    StrValueMap memStats;
+    strError = planMemory(argMap, train, test, memStats);
+    if ( !strError.empty() )
+        ERROR("  " << strError);
+
     // Creating Kernel Matrices
-    CDataMatrix Ktrain, Ktest;
+    CKernelMatrix*  pKtrain;
+    CDataMatrix     Ktest;
 
     cout << "* Creating Kernel Matrices... " << endl;
     CKernel     kernel(argMap);
-    StrValueMap kMap = kernel.serialize();
+    kernel.setNbThreads( argMap["threads"] );
 
-    Ktrain = createKernelMatrix(train, train, kernel);
-    cout << "  Train matrix : " << Ktrain.nbEx << " x " << Ktrain.nbFt << " elements." << endl;
+    // Explicit features of the kernel (random Fourier or exact), if any
+    CFeatureMap* pFeatures = CFeatureMap::create(argMap, kernel);
 
-    if (test.nbEx > 0)
+    // Gamma sweep: squared distances are computed once, kernel matrices are derived from them
+    vector<double>  gammas = getGammaSweep(argMap, kernel);
+    CDataMatrix     Dtrain, Dtest;
+
+    if ( !gammas.empty() )
+    {
+        Dtrain  = createSqrDistMatrix(train, train, kernel);
+        pKtrain = new CDenseKernelMatrix( Dtrain.duplicate(), true );
+        cout << "  Train matrix : " << pKtrain->nbEx << " x " << pKtrain->nbFt << " elements, for "
+             << gammas.size() << " gamma values." << endl;
+
+        if (bPipeline)
+        {
+            SSqrDistRows rows = { train, kernel };
+            if ( !createPipelinedMatrix(new_argv[2], pipelineSize, rows, Dtest) )
+                ERROR("  Error with file '" << new_argv[2] << "'.");
+        }
+        else if (test.nbEx > 0)
+        {
+            Dtest = createSqrDistMatrix(test, train, kernel);
+        }
+
+        if (Dtest.nbEx > 0)
+        {
+            Ktest = Dtest.duplicate();
+            cout << "  Test matrix  : " << Ktest.nbEx << " x " << Ktest.nbFt << " elements." << endl;
+        }
+    }
+    else if (pFeatures != NULL)
     {
-        Ktest = createKernelMatrix(test, train, kernel);
-        cout << "  Test matrix  : " << Ktest.nbEx << " x " << Ktest.nbFt << " elements." << endl;
+        // The train matrix is factored by the features (Z*Z'), test examples are mapped into
+        // the features space, where the final classifier is expressed
+        pKtrain = new CFactoredKernelMatrix( pFeatures->transform(train) );
+        cout << "  Train matrix : " << pKtrain->nbEx << " x " << pKtrain->nbFt << " elements, from "
+             << pFeatures->getNbFeatures(train.nbFt) << " " << pFeatures->getName() << "." << endl;
+
+        if (bPipeline)
+        {
+            SFeatureRows rows = { pFeatures };
+            if ( !createPipelinedMatrix(new_argv[2], pipelineSize, rows, Ktest) )
+                ERROR("  Error with file '" << new_argv[2] << "'.");
+        }
+        else if (test.nbEx > 0)
+        {
+            Ktest = pFeatures->transform(test, true);
+        }
+
+        if (Ktest.nbEx > 0)
+            cout << "  Test features: " << Ktest.nbEx << " x " << Ktest.nbFt << " elements." << endl;
     }
+    else
+    {
+        string trainFile = new_argv[1];
+        pKtrain = createTrainKernelMatrix(train, kernel, argMap,
+                                          kernelCacheFilename(argMap, kernel, trainFile, trainFile));
+
+        if (pKtrain == NULL)
+            ERROR("  Unable to create a scratch file in '" << argMap["outOfCore"] << "'.");
+
+        if (bPipeline)
+        {
+            SKernelRows rows = { train, kernel };
+            if ( !createPipelinedMatrix(new_argv[2], pipelineSize, rows, Ktest) )
+                ERROR("  Error with file '" << new_argv[2] << "'.");
+        }
+        else if (test.nbEx > 0)
+        {
+            string testFile = new_argv[2];
+            Ktest = createKernelMatrix(test, train, kernel, kernelCacheFilename(argMap, kernel, testFile, trainFile));
+        }
+
+        if (Ktest.nbEx > 0)
+            cout << "  Test matrix  : " << Ktest.nbEx << " x " << Ktest.nbFt << " elements." << endl;
+    }
+
+    if ( !CAllocator::getDefault().isDefault() )
+        cout << "  Memory placement: " << CAllocator::getDefault().getPlacement() << endl;
 
-    // Learn
-    CPbscAlignLearner algo;
+    // Merged examples weight the rows of the train matrix
+    pKtrain->setRowWeights(train.W);
 
-    algo.setTrainData(Ktrain);
-    if (Ktest.nbEx > 0)
-        algo.setTestData(Ktest);
+    // Learn (once per gamma value, in sweep mode)
+    for (size_t g = 0; g < max(gammas.size(), (size_t)1); ++g)
+    {
+        StrValueMap params = argMap;
 
-    algo.setParameters(argMap);
-    algo.init();
+        if ( !gammas.empty() )
+        {
+            params = getSweepParameters(argMap, gammas[g]);
+            kernel.unserialize(params);
 
-    cout << "* Learning..." << endl;
-    CClassifier* classifier = algo.learn();
+            cout << "* Kernel gamma = " << gammas[g] << "..." << endl;
+            fillRbfFromSqrDist(Dtrain, ((CDenseKernelMatrix*)pKtrain)->getDataMatrix(), kernel);
+            if (Ktest.nbEx > 0)
+                fillRbfFromSqrDist(Dtest, Ktest, kernel);
+        }
 
-    StrValueMap stats = algo.getStats();
-    stats.insert(kMap.begin(), kMap.end());
+        StrValueMap kMap = kernel.serialize();
 
-    cout << "* Testing..." << endl;
-    stats["Train Risk"] = classifier->calcRisk(Ktrain);
+        CPbscAlignLearner algo;
 
-    if (Ktest.nbEx > 0)
-        stats["Test Risk"]  = classifier->calcRisk(Ktest);
+        algo.setTrainData(pKtrain);
+        if (Ktest.nbEx > 0 && pFeatures == NULL)
+            algo.setTestData(Ktest);
 
-    cout << endl;
+        algo.setParameters(params);
+        algo.init();
 
-    FileUtils::writeStrValueMap(stats, cout);
+        cout << "* Learning..." << endl;
+        CClassifier* classifier = algo.learn();
 
-    strParam = (string)argMap["stats"];
-    if (strParam != "0")
-        FileUtils::saveStrValueMap(stats, strParam.c_str() );
+        if (pFeatures != NULL)
+        {
+            classifier = createPrimalClassifier(classifier, (CFactoredKernelMatrix*)pKtrain);
+            kMap = pFeatures->serialize();
+        }
 
-    strParam = (string)argMap["model"];
-    if (strParam != "0")
-    {
-        StrValueMap srlz = classifier->serialize();
-        srlz.insert(kMap.begin(), kMap.end());
-        FileUtils::saveStrValueMap(srlz, strParam.c_str() );
+        StrValueMap stats = algo.getStats();
+        stats.insert(kMap.begin(), kMap.end());
+        stats.insert(memStats.begin(), memStats.end());
+
+        if ( !CAllocator::getDefault().isDefault() )
+            stats["Memory placement"] = CAllocator::getDefault().getPlacement();
+
+        cout << "* Testing..." << endl;
+        if (Ktest.nbEx > 0)
+            stats["Test Risk"]  = classifier->calcRisk(Ktest);
+
+        cout << endl;
+
+        FileUtils::writeStrValueMap(stats, cout);
+
+        strParam = (string)params["stats"];
+        if (strParam != "0")
+            FileUtils::saveStrValueMap(stats, strParam.c_str() );
+
+        strParam = (string)params["model"];
+        if (strParam != "0")
+        {
+            StrValueMap srlz = classifier->serialize();
+            srlz.insert(kMap.begin(), kMap.end());
+            if ( (bool)params["dedup"] && pFeatures == NULL )
+                srlz["dedup"] = 1;  // the classifier columns are the distinct training examples
+            if ( !coreset.empty() && pFeatures == NULL )
+                srlz["coreset"] = coreset;  // the classifier columns are these training examples
+            FileUtils::saveStrValueMap(srlz, strParam.c_str() );
+        }
+
+        classifier->free();
+        algo.free();
     }
 
     // Freeing memory
-    classifier->free();
-    algo.free();
     train.free();
     test.free();
-    Ktrain.free();
+    pKtrain->free();
+    delete pKtrain;
     Ktest.free();
+    Dtrain.free();
+    Dtest.free();
+    delete pFeatures;
 
     return EXIT_SUCCESS;
 }
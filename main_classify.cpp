@@ -18,22 +18,37 @@
 #include "common.h"
 
 #include "Classifiers/LinearClassifier.h"
+#include "Datas/DataStream.h"
 
 using namespace std;
 
 const char* STR_USAGE =
-    "Usage: pbsc_classify [-label <value>] train_file test_file [model_file] [prediction_file] \n"
+    "Usage: pbsc_classify [-label <value>] [-threads <value>] [-chunk <value>] [-alloc.hugepages <value>] [-alloc.numa <value>] train_file test_file [model_file] [prediction_file] \n"
     "\n"
     "Required parameters: \n"
     "    train_file      Training dataset file  (tab/space separated, one exemple per line, \n"
-    "                                            first column contains -1/+1 labels) \n"
+    "                                            first column contains -1/+1 labels). Sparse files \n"
+    "                                            list 'index:value' pairs after the label, \n"
+    "                                            with indices starting at 1) \n"
+    "                    Dense files whose features are all -1, 0 or +1 are also bit-packed: this only \n"
+    "                    speeds up the kernel computation, the features remain in memory as doubles \n"
     "    test_file       Testing dataset file   (same format than the training dataset file) \n"
     "\n"
     "Optionnal parameters: \n"
-    "    model_file      Classifier file name outputed by the learner (default='classifier.ini') \n"
+    "    model_file      Classifier file name outputed by the learner (default='classifier.ini'). \n"
+    "                    A model learned with explicit features (-rff.D or -factored) classifies the \n"
+    "                    test examples from these features only (the train file is then not loaded) \n"
     "    prediction_file Write predictions into that file \n"
     "\n"
-    "    -label          Indicates if the test file contains label (0=no label, default=1) \n";
+    "    -label          Indicates if the test file contains label (0=no label, default=1) \n"
+    "    -threads        Number of threads computing the kernel matrix (0=all processors, default=1) \n"
+    "    -chunk          Number of test examples read and classified at a time: the kernel matrix holds \n"
+    "                    only their rows, and the predictions are written as soon as they are known, \n"
+    "                    whatever the size of the test file (default=1000) \n"
+    "    -alloc.hugepages  Pages of the kernel matrix and datasets, ie 'transparent' or 'explicit' huge pages \n"
+    "                    (see pbsc_align) (0=system pages, default=0) \n"
+    "    -alloc.numa     NUMA placement of the same pages, ie 'interleave' or 'partition' (see pbsc_align) \n"
+    "                    (0=first touch, default=0) \n";
 
 
 int main(int argc, char **argv)
@@ -44,6 +59,10 @@ int main(int argc, char **argv)
     // Parse parameters
     StrValueMap argMap;
     argMap["label"] = true;
+    argMap["threads"] = 1;
+    argMap["chunk"] = 1000;
+    argMap["alloc.hugepages"] = 0;
+    argMap["alloc.numa"] = 0;
 
     bool bHelp;
     vector<CStrValue> new_argv = FileUtils::parseCmdLine(argMap, argc, argv, bHelp);
@@ -52,6 +71,14 @@ int main(int argc, char **argv)
     if (bHelp || new_argc < 3)
         ERROR( STR_USAGE );
 
+    // Parameters checked before any computation
+    string strError = checkAllocParameters(argMap);
+    if ( !strError.empty() )
+        ERROR("  " << strError);
+
+    // Placement of the large matrices memory (-alloc.hugepages, -alloc.numa)
+    CAllocator::getDefault() = CAllocator(argMap["alloc.hugepages"], argMap["alloc.numa"], argMap["threads"]);
+
     CLinearClassifier classifier(0);
     CKernel kernel;
 
@@ -63,65 +90,119 @@ int main(int argc, char **argv)
     cout << "  Weight vector cardinality: " << classifier.getCardinality() << endl;
 
     kernel.unserialize(map);
+    kernel.setNbThreads( argMap["threads"] );
     StrValueMap kernelMap = kernel.serialize();
     cout << "  Kernel type: " << kernelMap["kernel"] << endl;
 
-    // Load dataset files
-    CDataMatrix train, test;
+    // Model on explicit features (recreated from their parameters)
+    CFeatureMap* pFeatures = CFeatureMap::create(map, kernel);
 
-    cout << "* Loading train file..." << endl;
-    if ( train.loadFromFile( new_argv[1].c_str() ) )
-        cout << "  " << train.nbEx << " examples loaded." << endl;
-    else
-        ERROR("  Error with file '" << new_argv[1] << "'.");
+    if (pFeatures != NULL)
+        cout << "  Features: " << pFeatures->getName() << endl;
 
+    // Load train file (the test file is read by chunks below)
+    CDataMatrix train;
 
-    cout << "* Loading test file..." << endl;
-    if( test.loadFromFile( new_argv[2].c_str(), (bool)argMap["label"] ) )
-        cout << "  " << test.nbEx << " examples loaded." << endl;
-    else
-        ERROR("  Error with file '" << new_argv[2] << "'.");
+    if (pFeatures == NULL)
+    {
+        cout << "* Loading train file..." << endl;
+        if ( train.loadFromFile( new_argv[1].c_str() ) )
+            cout << "  " << train.nbEx << " examples loaded." << endl;
+        else
+            ERROR("  Error with file '" << new_argv[1] << "'.");
+
+        // The model was learned on the distinct training examples (-dedup)
+        if ( map.count("dedup") > 0 && (bool)map["dedup"] )
+        {
+            train.mergeDuplicates();
+            cout << "  " << train.nbEx << " distinct examples." << endl;
+        }
+
+        // The model was learned on a coreset of the training examples (-coreset.size)
+        if ( map.count("coreset") > 0 )
+        {
+            CDataMatrix coreset = train.copyExamples( (vector<int>)map["coreset"] );
+            train.free();
+            train = coreset;
+            cout << "  " << train.nbEx << " coreset examples." << endl;
+        }
+    }
 
-    // Creating Kernel Matrices
-    CDataMatrix Ktest;
 
-    cout << "* Creating Kernel Matrix... " << endl;
-    Ktest = createKernelMatrix(test, train, kernel);
-    cout << "  Test matrix  : " << Ktest.nbEx << " x " << Ktest.nbFt << " elements." << endl;
+    // The test file is classified by chunks of examples: the test matrix is never formed whole,
+    // and the memory does not depend on the number of test examples
+    bool bLabels   = argMap["label"];
+    int  chunkSize = argMap["chunk"];
 
-    // Compute classification
-    gsl_vector* vPred = gsl_vector_alloc(test.nbEx);
+    if (chunkSize < 1)
+        ERROR("  Invalid chunk size " << chunkSize << ".");
 
-    if ( (bool)argMap["label"] )
+    CDataStream stream;
+    if ( !stream.open( new_argv[2].c_str(), bLabels ) )
+        ERROR("  Error with file '" << new_argv[2] << "'.");
+
+    // Explicit features are computed from dense examples only
+    if (pFeatures != NULL && stream.isSparse())
+        ERROR("  A model on explicit features classifies dense examples, not sparse ones.");
+
+    cout << (bLabels ? "* Testing" : "* Predicting labels") << " by chunks of " << chunkSize << " examples..." << endl;
+
+    // Unlabeled examples are only read to write their predictions
+    if (!bLabels && new_argc < 5)
     {
-        cout << "* Testing..." << endl;
-        cout << "Risk = " << classifier.calcRisk(Ktest, vPred) << endl;
+        cout << "  Warning: It is useless to predict if you do not write the result in a file!" << endl;
+        stream.close();
     }
-    else
-    {
-        cout << "* Predicting labels..." << endl;
 
-        if (new_argc < 4)
-            cout << "  Warning: It is useless to predict if you do not write the result in a file!" << endl;
-        else
-            classifier.classify(Ktest, vPred);
-    }
+    FILE* out = (new_argc > 4) ? fopen(new_argv[4].c_str(), "wt") : NULL;
 
-    // Save predictions
-    if (new_argc > 4)
+    CDataMatrix chunk, Kchunk;
+    long nbErrors = 0;
+    int  nbRead;
+
+    while ( (nbRead = stream.read(chunk, chunkSize)) > 0 )
     {
-        cout << "Save predictions..." << endl;
+        // Kernel values (or features) of the chunk, then its predictions
+        if (pFeatures != NULL)
+            Kchunk = pFeatures->transform(chunk, true);
+        else
+            Kchunk = createKernelMatrix(chunk, train, kernel);
 
-        FILE* out = fopen(new_argv[4].c_str(), "wt");
-        gsl_vector_fprintf(out, vPred,"%f");
-        fclose(out);
+        gsl_vector* vPred = gsl_vector_alloc(chunk.nbEx);
+        classifier.classify(Kchunk, vPred);
+
+        if (bLabels)
+            nbErrors += CClassifier::countErrors(chunk, vPred);
+
+        // Save predictions (as soon as they are known)
+        if (out != NULL)
+        {
+            gsl_vector_fprintf(out, vPred, "%f");
+            fflush(out);
+        }
+
+        gsl_vector_free(vPred);
+        Kchunk.free();
+        chunk.free();
     }
 
+    if (out != NULL)
+        fclose(out);
+
+    if (nbRead < 0)
+        ERROR("  Error with file '" << new_argv[2] << "'.");
+
+    cout << "  " << stream.getNbRead() << " examples classified." << endl;
+
+    if ( !CAllocator::getDefault().isDefault() )
+        cout << "  Memory placement: " << CAllocator::getDefault().getPlacement() << endl;
+
+    if (bLabels)
+        cout << "Risk = " << (stream.getNbRead() > 0 ? (double)nbErrors / stream.getNbRead() : 0.0) << endl;
+
     // Desallocate memory
-    gsl_vector_free(vPred);
     classifier.free();
-    Ktest.free();
-    test.free();
+    delete pFeatures;
     train.free();
     return EXIT_SUCCESS;
 }
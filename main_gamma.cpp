@@ -0,0 +1,123 @@
+// ------------------------------------------------------------------------------------------------
+// PAC-BAYES SAMPLE COMPRESS LEARNING ALGORITHM (aka PBSC) 
+// Version 0.92 (June 26, 2011), Released under the BSD-license 
+// ------------------------------------------------------------------------------------------------
+// Author: 
+//    Pascal Germain 
+//    Groupe de Recherche en Apprentissage Automatique de l'Universite Laval (GRAAL) 
+//    http://graal.ift.ulaval.ca/ 
+//
+// Reference: 
+//    Pascal Germain, Alexandre Lacoste, François Laviolette, Mario Marchand, and Sara Shanian. 
+//    A PAC-Bayes Sample Compression Approach to Kernel Methods. In Proceedings of the 28th 
+//    International Conference on Machine Learning, Bellevue, WA, USA, June 2011. 
+// ------------------------------------------------------------------------------------------------
+
+
+
+#define  STR_APPNAME "KERNEL GAMMA SELECTION"
+#include "common.h"
+
+using namespace std;
+
+const char* STR_USAGE =
+    "Usage: pbsc_gamma [-first_parameter <value>] ... [-last_parameter <value>] train_file \n"
+    "\n"
+    "Selects the gamma parameter of the RBF kernel without learning: the kernel-target alignment \n"
+    "<K,yy'> / (||K|| ||yy'||) is maximized on random subsamples of the training examples. The median \n"
+    "heuristic (gamma = 1 / median of the squared distances) is used when the alignment is not \n"
+    "informative. The same selection is done by the learners with '-kernel.gamma auto'. \n"
+    "\n"
+    "Required parameters: \n"
+    "    train_file      Training dataset file  (tab/space separated, one exemple per line, \n"
+    "                                            first column contains -1/+1 labels). Sparse files \n"
+    "                                            list 'index:value' pairs after the label, \n"
+    "                                            with indices starting at 1) \n"
+    "                    Dense files whose features are all -1, 0 or +1 are also bit-packed: this only \n"
+    "                    speeds up the kernel computation, the features remain in memory as doubles \n"
+    "\n"
+    "Optionnal parameters: \n"
+    "    -gammaAuto.m    Examples by subsample (default=500) \n"
+    "    -gammaAuto.nb   Number of subsamples (default=5) \n"
+    "    -seed           Random generator seed (defaut=<System time>) \n"
+    "    -threads        Number of threads computing the distances (0=all processors, default=1) \n"
+    "    -output         Write the selected kernel parameters into that file, which can be given to \n"
+    "                    the learners as a config file (0=none, default=0) \n"
+    "\n"
+    "Example: \n"
+    "       ./pbsc_gamma -output gamma.ini USvotes_train.dat \n"
+    "       ./pbsc_align -config gamma.ini USvotes_train.dat USvotes_test.dat \n"
+    ;
+
+
+int main(int argc, char **argv)
+{
+    // Print header
+    cout << STR_HEADER << endl;
+
+    // Parse parameters
+    StrValueMap argMap;
+    argMap["threads"]      = 1;
+    argMap["output"]       = 0;
+    argMap["gammaAuto.m"]  = 500;
+    argMap["gammaAuto.nb"] = 5;
+
+    bool bHelp;
+    vector<CStrValue> new_argv = FileUtils::parseCmdLine(argMap, argc, argv, bHelp);
+    int new_argc = new_argv.size();
+
+    if (bHelp || new_argc < 2)
+        ERROR( STR_USAGE );
+
+    // Load dataset file
+    CDataMatrix train;
+
+    cout << "* Loading train file..." << endl;
+    if ( train.loadFromFile( new_argv[1].c_str() ) )
+        cout << "  " << train.nbEx << " examples loaded." << endl;
+    else
+        ERROR("  Error with file '" << new_argv[1] << "'.");
+
+    // Select gamma
+    CKernel kernel;
+    kernel.setNbThreads( argMap["threads"] );
+
+    unsigned long seed = argMap.count("seed") ? (int)argMap["seed"] : time(NULL);
+
+    cout << "* Selecting kernel gamma..." << endl;
+    CGammaSelector selector(kernel, argMap["gammaAuto.m"], argMap["gammaAuto.nb"], seed);
+    double gamma = selector.select(train);
+
+    // Alignment of the examined values
+    const vector<double>& grid       = selector.getGrid();
+    const vector<double>& alignments = selector.getAlignments();
+
+    if ( !grid.empty() )
+    {
+        cout << endl << setw(16) << "gamma" << setw(16) << "alignment" << endl;
+        for (size_t k = 0; k < grid.size(); ++k)
+            cout << setw(16) << grid[k] << setw(16) << alignments[k] << endl;
+        cout << endl;
+    }
+
+    StrValueMap result;
+    result["kernel"]        = "RBF";
+    result["kernel.gamma"]  = gamma;
+
+    StrValueMap stats = result;
+    stats["Median gamma"]           = selector.getMedianGamma();
+    stats["Selection"]              = selector.isAligned() ? "kernel-target alignment" : "median heuristic";
+    if ( selector.isAligned() )
+        stats["Alignment"]          = selector.alignment(gamma);
+
+    FileUtils::writeStrValueMap(stats, cout);
+
+    string strParam = argMap["output"];
+    if (strParam != "0")
+        FileUtils::saveStrValueMap(result, strParam.c_str());
+
+    // Desallocate memory
+    selector.free();
+    train.free();
+    return EXIT_SUCCESS;
+}